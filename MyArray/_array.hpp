@@ -1,14 +1,62 @@
 #ifndef DYNAMICARRAY_H
 #define DYNAMICARRAY_H
+#include <new>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <thread>
+#include <vector>
+#include <exception>
+#include <cstdint>
+#include <limits>
 #include "array_iterator.hpp"
+#include "growth_policy.hpp"
+#include "array_simd.hpp"
+#include "aligned_allocator.hpp"
+#include "mmap_allocator.hpp"
+#include "file_allocator.hpp"
+#include "../_binary.hpp"
+#include "../_format.hpp"
+
+/// True if T can be moved to another address by copying its bytes.
+/// Defaults to trivially copyable types, may be specialized for types
+/// that own resources but hold no pointers into themselves
+template<typename T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+/// Uninitialized memory for N elements kept inside of an Array object
+template<typename T, int N>
+struct InlineStorage {
+    alignas(T) unsigned char bytes[sizeof(T) * N];
 
-/// Dynamic Array class with two buffers
+    T* data() {
+        return reinterpret_cast<T*>(bytes);
+    };
+    const T* data() const {
+        return reinterpret_cast<const T*>(bytes);
+    };
+};
 template<typename T>
+struct InlineStorage<T, 0> {
+    T* data() const {
+        return 0;
+    };
+};
+
+/// Dynamic Array class with two buffers.
+/// Growth decides how much spare memory is reserved on the side being extended,
+/// memory and elements are managed through Allocator.
+/// Up to Inline elements are stored inside of the object without touching Allocator
+template<typename T, typename Growth = GeometricGrowth<>, typename Allocator = std::allocator<T>, int Inline = 0>
 class Array {
 public:
     using InitializerFunction = T (*)(const int& index);
+    /// least amount of elements processed by one thread of parallel_apply
+    static constexpr int parallel_apply_run = 1 << 15;
     using iterator = ArrayIterator<T>;
     using const_iterator = ConstArrayIterator<T>;
+    using allocator_type = Allocator;
 
 private:
     using pointer = T*;
@@ -16,6 +64,7 @@ private:
     using reference = T&;
     using const_reference = const T&;
     using value = T;
+    using alloc_traits = std::allocator_traits<Allocator>;
 
     /// current amount of allocated memory
     int allocated_ = 0;
@@ -23,25 +72,133 @@ private:
     int left_buffer_ = 0;
     /// current size of right buffer (is part of allocated)
     int right_buffer_ = 0;
-    /// preset amount of buffer by which the array is_extended all of the time
+    /// least amount of buffer by which the array is extended
     int buffer_size_ = 10;
+    /// buffers requested by reserve(), automatic trimming never goes below them
+    int reserved_left_ = 0;
+    int reserved_right_ = 0;
     /// data storage location
     pointer data_ = 0;
+    /// provides memory of data_ and constructs elements in it
+    Allocator allocator_;
+    /// memory used instead of allocating while array is small
+    InlineStorage<T, Inline> inline_;
+
+    /// true if data_ is stored inside of the object
+    inline bool _is_inline() const {
+        return Inline > 0 && data_ == inline_.data();
+    };
+    /// Inline memory is given out if it fits, even if data_ already occupies it:
+    /// relocation between overlapping ranges is safe
+    inline pointer _alloc(const int& size) {
+        if(Inline > 0 && size <= Inline)
+            return inline_.data();
+        return alloc_traits::allocate(allocator_, size);
+    };
+    /// frees data_ of allocated_ size, elements must be destroyed before
+    inline void _free() {
+        if(data_ != 0 && !_is_inline())
+            alloc_traits::deallocate(allocator_, data_, allocated_);
+    };
+    /// Sets up new memory for count uninitialized elements.
+    /// Inline memory is filled completely with spare slots split between both sides
+    void _init_storage(const int& count) {
+        if(Inline > 0 && count <= Inline) {
+            allocated_ = Inline;
+            left_buffer_ = (Inline - count) / 2;
+            right_buffer_ = Inline - count - left_buffer_;
+        } else {
+            allocated_ = count + 2 * buffer_size_;
+            left_buffer_ = right_buffer_ = buffer_size_;
+        };
+        data_ = _alloc(allocated_);
+    };
+
+    /// Element types that are copied with memcpy and moved with memmove,
+    /// others are placement-new constructed, moved and destroyed one by one
+    static constexpr bool _copy_bitwise = std::is_trivially_copyable<T>::value;
+    static constexpr bool _move_bitwise = is_trivially_relocatable<T>::value;
+    /// Heap blocks are resized in place with Allocator::reallocate() (e.g. mremap)
+    static constexpr bool _remap = _move_bitwise && has_reallocate<Allocator>::value;
 
-    inline pointer _alloc(const int& size) const {
-        return pointer(calloc(size, el_size()));
+    /// true if memory of data_ can be resized to new_alloc by Allocator::reallocate()
+    inline bool _can_remap(const int& new_alloc) const {
+        return _remap && data_ != 0 && !_is_inline() && new_alloc > Inline;
+    };
+
+    /// copy constructs count elements from 'from' in uninitialized memory at 'to'
+    template<typename InputIterator>
+    void _construct_copies(pointer to, InputIterator from, const int& count) {
+        if constexpr(_copy_bitwise && std::is_pointer<InputIterator>::value)
+            memcpy(to, from, sizeof(T) * count);
+        else {
+            int i = 0;
+            try {
+                for(; i < count; ++i, ++from)
+                    alloc_traits::construct(allocator_, to + i, *from);
+            } catch(...) {
+                _destroy(to, i);
+                throw;
+            };
+        };
+    };
+    /// constructs count copies of data in uninitialized memory at 'to'
+    void _construct_fill(pointer to, const_reference data, const int& count) {
+        int i = 0;
+        try {
+            for(; i < count; ++i)
+                alloc_traits::construct(allocator_, to + i, data);
+        } catch(...) {
+            _destroy(to, i);
+            throw;
+        };
+    };
+    /// Moves count elements to uninitialized memory at 'to' leaving 'from' uninitialized.
+    /// Ranges may overlap
+    void _relocate(pointer to, pointer from, const int& count) {
+        if(to == from || count <= 0)
+            return;
+        if constexpr(_move_bitwise)
+            memmove(to, from, sizeof(T) * count);
+        else if(to < from)
+            for(int i = 0; i < count; ++i) {
+                alloc_traits::construct(allocator_, to + i, std::move(from[i]));
+                alloc_traits::destroy(allocator_, from + i);
+            }
+        else
+            for(int i = count - 1; i >= 0; --i) {
+                alloc_traits::construct(allocator_, to + i, std::move(from[i]));
+                alloc_traits::destroy(allocator_, from + i);
+            };
+    };
+    /// destroys count elements at 'from'
+    void _destroy(pointer from, const int& count) {
+        if constexpr(!std::is_trivially_destructible<T>::value)
+            for(int i = 0; i < count; ++i)
+                alloc_traits::destroy(allocator_, from + i);
     };
 
     /// Reallocates all data to new memory of new_alloc size.
     /// If it is less than previous memory than excess elements will be cleared going backwards
     void _realloc_right(const int& new_alloc = 1){
         _check_except_size(new_alloc);
+        if constexpr(_remap)
+            if(_can_remap(new_alloc)) {
+                // elements stay where they are, the ones past new_alloc are cut
+                int kept = std::max(0, std::min(new_alloc - left_buffer_, size()));
+                _destroy(data_ + left_buffer_ + kept, size() - kept);
+                left_buffer_ = std::min(left_buffer_, new_alloc);
+                data_ = allocator_.reallocate(data_, allocated_, new_alloc);
+                right_buffer_ = new_alloc - left_buffer_ - kept;
+                allocated_ = new_alloc;
+                return;
+            };
         pointer tmp = _alloc(new_alloc);
 
         if(new_alloc >= allocated_) {
             // copy contents and increase buffer size aka extend array
             int memory_diff = new_alloc  - allocated_;
-            memcpy(tmp + left_buffer_, data_ + left_buffer_, el_size() * size());
+            _relocate(tmp + left_buffer_, data_ + left_buffer_, size());
             right_buffer_ += memory_diff;
         } else {
             // copy any contents and decrease buffer size aka cut left side of array
@@ -50,20 +207,23 @@ private:
 
             if(memory_diff <= right_buffer_) {
                 // only right buffer decreases
-                memcpy(tmp + left_buffer_, data_ + left_buffer_, el_size() * size());
+                _relocate(tmp + left_buffer_, data_ + left_buffer_, size());
                 right_buffer_ -= memory_diff;
             } else if(new_alloc >= left_buffer_) {
                 // right buffer is gone and some elements are also deleted
-                memcpy(tmp + left_buffer_, data_ + left_buffer_, el_size() * (new_alloc - left_buffer_));
+                int kept = new_alloc - left_buffer_;
+                _destroy(data_ + left_buffer_ + kept, size() - kept);
+                _relocate(tmp + left_buffer_, data_ + left_buffer_, kept);
                 right_buffer_ = 0;
             } else { //(new_alloc < left_buffer_)
                     // left buffer also decreases
+                    _destroy(data_ + left_buffer_, size());
                     right_buffer_ = 0;
                     left_buffer_ = new_alloc;
             };
         };
 
-        free(data_);
+        _free();
         data_ = tmp;
         allocated_ = new_alloc;
     };
@@ -72,12 +232,28 @@ private:
     /// If it is less than previous memory than excess elements will be cleared
     void _realloc_left(const int& new_alloc = 1) {
         _check_except_size(new_alloc);
+        if constexpr(_remap)
+            if(_can_remap(new_alloc)) {
+                // block is resized at its end, elements are moved once inside of it
+                int kept = std::max(0, std::min(new_alloc - right_buffer_, size()));
+                int new_left = new_alloc - std::min(right_buffer_, new_alloc) - kept;
+                _destroy(data_ + left_buffer_, size() - kept);
+                if(new_alloc >= allocated_)
+                    data_ = allocator_.reallocate(data_, allocated_, new_alloc);
+                _relocate(data_ + new_left, data_ + left_buffer_ + size() - kept, kept);
+                if(new_alloc < allocated_)
+                    data_ = allocator_.reallocate(data_, allocated_, new_alloc);
+                left_buffer_ = new_left;
+                right_buffer_ = new_alloc - new_left - kept;
+                allocated_ = new_alloc;
+                return;
+            };
         pointer tmp = _alloc(new_alloc);
 
         if(new_alloc >= allocated_) {
             // copy contents and increase buffer size aka extend array
             int memory_diff = new_alloc  - allocated_;
-            memcpy(tmp + left_buffer_ + memory_diff, data_ + left_buffer_, el_size() * size());
+            _relocate(tmp + left_buffer_ + memory_diff, data_ + left_buffer_, size());
             left_buffer_ += memory_diff;
         } else {
             // copy any contents and decrease buffer size aka cut right side of array
@@ -86,20 +262,23 @@ private:
 
             if(memory_diff <= left_buffer_) {
                 // only left buffer decreases
-                memcpy(tmp + memory_diff, data_ + left_buffer_, el_size() * size());
-                right_buffer_ -= memory_diff;
+                _relocate(tmp + left_buffer_ - memory_diff, data_ + left_buffer_, size());
+                left_buffer_ -= memory_diff;
             } else if(new_alloc >= right_buffer_) {
                 // left buffer is gone and some elements are also deleted
-                memcpy(tmp, data_ + memory_diff, el_size() * (new_alloc - right_buffer_));
+                int kept = new_alloc - right_buffer_;
+                _destroy(data_ + left_buffer_, size() - kept);
+                _relocate(tmp, data_ + memory_diff, kept);
                 left_buffer_ = 0;
             } else { //(new_alloc < left_buffer_)
                     // right buffer also decreases
+                    _destroy(data_ + left_buffer_, size());
                     left_buffer_ = 0;
                     right_buffer_ = new_alloc;
             };
         };
 
-        free(data_);
+        _free();
         data_ = tmp;
         allocated_ = new_alloc;
     };
@@ -108,10 +287,24 @@ private:
     /// Copies elements from old memory starting from index leaving left_buffer__ elements empty at left.
     /// Requires you to set buffers sizes yourself
     void _realloc_both(const int& new_alloc, const int& left_buffer__ = 10, const int& index = 0) {
+        if constexpr(_remap)
+            if(_can_remap(new_alloc)) {
+                _destroy(data_ + left_buffer_, index);
+                if(new_alloc >= allocated_)
+                    data_ = allocator_.reallocate(data_, allocated_, new_alloc);
+                _relocate(data_ + left_buffer__, data_ + left_buffer_ + index, size() - index);
+                if(new_alloc < allocated_)
+                    data_ = allocator_.reallocate(data_, allocated_, new_alloc);
+                right_buffer_ += left_buffer_ + index - left_buffer__ + new_alloc - allocated_;
+                allocated_ = new_alloc;
+                left_buffer_ = left_buffer__;
+                return;
+            };
         T* tmp = _alloc(new_alloc);
-        memcpy(tmp + left_buffer__, data_ + left_buffer_ + index, el_size() * (size() - index));
+        _destroy(data_ + left_buffer_, index);
+        _relocate(tmp + left_buffer__, data_ + left_buffer_ + index, size() - index);
 
-        free(data_);
+        _free();
         data_ = tmp;
         allocated_ = new_alloc;
         left_buffer_ = left_buffer__;
@@ -122,47 +315,155 @@ private:
         *(data_ + index) = data;
     };
 
-    /// automatic check for deallocation of excess memory
-    void _dealloc_check(const int& factor = 2) {
-        if(left_buffer_ > factor * buffer_size_) {
-            if(right_buffer_ > factor * buffer_size_)
-                /// deallocs both sides
-                __alloc_checks_helper();
-            else
-                /// dealloc only left
-                _realloc_left(allocated_ - left_buffer_ + buffer_size_);
-        } else if(right_buffer_ > factor * buffer_size_) {
-            if(left_buffer_> factor * buffer_size_)
-                /// deallocs both sides
-                __alloc_checks_helper();
-            else
-                /// dealloc only right
-                _realloc_right(allocated_ - right_buffer_ + buffer_size_);
+    /// amount of spare slots Growth gives to an extended side
+    inline int _spare() const {
+        return Growth::spare(size(), buffer_size_);
+    };
+    /// makes at least count slots free on the right side
+    void _grow_right(const int& count) {
+        if(count <= right_buffer_)
+            return;
+        if(_is_inline() && left_buffer_ + right_buffer_ >= count)
+            // inline memory is filled before spilling to the heap
+            _shift_to((left_buffer_ + right_buffer_ - count) / 2);
+        else
+            _realloc_right(allocated_ - right_buffer_ + count + _spare());
+    };
+    /// makes at least count slots free on the left side
+    void _grow_left(const int& count) {
+        if(count <= left_buffer_)
+            return;
+        if(_is_inline() && left_buffer_ + right_buffer_ >= count)
+            _shift_to(count + (left_buffer_ + right_buffer_ - count) / 2);
+        else
+            _realloc_left(allocated_ - left_buffer_ + count + _spare());
+    };
+
+    /// Automatic check for deallocation of excess memory.
+    /// A side is trimmed once it holds more than factor * spare slots and keeps
+    /// factor / 2 * spare of them (at least spare), so a trimmed side takes many pushes
+    /// to grow again and a grown side many pops to be trimmed, capacity does not oscillate.
+    /// Buffers requested by reserve() are kept, inline memory is never trimmed
+    void _dealloc_check(const int& factor = 4) {
+        if(_is_inline())
+            return;
+        int spare = _spare();
+        int limit = factor * spare;
+        int keep = factor > 2 ? factor / 2 * spare : spare;
+        int keep_left = std::max(keep, reserved_left_),
+            keep_right = std::max(keep, reserved_right_);
+        bool left = left_buffer_ > std::max(limit, reserved_left_),
+             right = right_buffer_ > std::max(limit, reserved_right_);
+
+        if(left && right)
+            /// deallocs both sides
+            __alloc_checks_helper(keep_left, keep_right);
+        else if(left)
+            /// dealloc only left
+            _realloc_left(allocated_ - left_buffer_ + keep_left);
+        else if(right)
+            /// dealloc only right
+            _realloc_right(allocated_ - right_buffer_ + keep_right);
+    };
+    /// regulates reallocating both directions
+    void __alloc_checks_helper(const int& left, const int& right) {
+        _realloc_both(size() + left + right, left);
+        right_buffer_ = right;
+    };
+
+    /// Moves elements inside of allocated memory so that the left buffer becomes new_left
+    void _shift_to(const int& new_left) {
+        _relocate(data_ + new_left, data_ + left_buffer_, size());
+        right_buffer_ += left_buffer_ - new_left;
+        left_buffer_ = new_left;
+    };
+    /// Opens a gap of count slots before index by shifting the shorter side
+    /// into its buffer. If that buffer is exhausted while the other one has room
+    /// spare slots are split evenly once, memory is reallocated only if both are exhausted.
+    /// Returns pointer to the first slot of the gap
+    pointer _open_gap(const int& index, const int& count) {
+        bool left = index < size() - index;
+        int free = left_buffer_ + right_buffer_;
+        if((left ? left_buffer_ : right_buffer_) < count && free >= count) {
+            int half = (free - count) / 2;
+            _shift_to(left ? count + half : half);
+        };
+
+        if(left) {
+            _grow_left(count);
+            pointer first = data_ + left_buffer_;
+            _relocate(first - count, first, index);
+            left_buffer_ -= count;
+        } else {
+            _grow_right(count);
+            pointer first = data_ + left_buffer_ + index;
+            _relocate(first + count, first, size() - index);
+            right_buffer_ -= count;
+        };
+        return data_ + left_buffer_ + index;
+    };
+    /// Destroys count elements starting at index and closes the gap
+    /// by shifting the shorter side over it
+    void _close_gap(const int& index, const int& count) {
+        pointer first = data_ + left_buffer_;
+        _destroy(first + index, count);
+        if(index < size() - index - count) {
+            _relocate(first + count, first, index);
+            left_buffer_ += count;
+        } else {
+            _relocate(first + index, first + index + count, size() - index - count);
+            right_buffer_ += count;
         };
     };
-    /// automatic check for reallocation for more memory
-    void _realloc_check() {
-        if(left_buffer_ == 0) {
-            if(right_buffer_ < buffer_size_ / 2)
-                /// also extends right
-                __alloc_checks_helper();
-            else
-                /// extends only left
-                _realloc_left(allocated_ - left_buffer_ + buffer_size_);
-        } else if(right_buffer_ == 0) {
-            if(left_buffer_ < buffer_size_ / 2)
-                /// also extends left
-                __alloc_checks_helper();
+    /// Constructs copies of a range at the end reserving memory once.
+    /// Count is used if evaluating distance between iterators is slow else -1 is defaulted
+    template<typename ForwardIterator>
+    void _append_range(const ForwardIterator& from, const ForwardIterator& to, const int& count = -1) {
+        int count_ = count == -1 ? int(to - from) : count;
+        _grow_right(count_);
+        for(auto iter = from; iter != to; ++iter) {
+            alloc_traits::construct(allocator_, data_ + allocated_ - right_buffer_, *iter);
+            --right_buffer_;
+        };
+    };
+
+    /// applies function to elements in [from, to) assigning returned values
+    template<typename Function, typename ...Arguments>
+    static void _apply(pointer from, pointer to, Function& function, Arguments&... function_args) {
+        using result = decltype(function(*from, function_args...));
+        for(; from != to; ++from)
+            if constexpr(std::is_void<result>::value)
+                function(*from, function_args...);
             else
-                /// extends only right
-                _realloc_right(allocated_ - right_buffer_ + buffer_size_);
+                *from = function(*from, function_args...);
+    };
+
+    /// Copies count elements from 'from' into a gap opened at index.
+    /// 'from' must not point into this array
+    template<typename InputIterator>
+    void _insert_copies(const int& index, InputIterator from, const int& count) {
+        pointer gap = _open_gap(index, count);
+        try {
+            _construct_copies(gap, from, count);
+        } catch(...) {
+            // gap is closed without destroying anything
+            _relocate(gap, gap + count, size() - index - count);
+            right_buffer_ += count;
+            throw;
         };
     };
-    /// regulates reallocating both directions
-    void __alloc_checks_helper() {
-        int tmp = size() + buffer_size_ * 2;
-        _realloc_both(tmp, buffer_size_);
-        right_buffer_ = buffer_size_;
+
+    /// true if ptr points into array's memory
+    inline bool _owns(const_pointer ptr) const {
+        return std::greater_equal<const_pointer>()(ptr, data_) &&
+               std::less<const_pointer>()(ptr, data_ + allocated_);
+    };
+    /// true if a range of count elements starting at 'from' is stored in this array
+    template<typename ForwardIterator>
+    bool _owns_range(const ForwardIterator& from, const int& count) const {
+        if constexpr(std::is_lvalue_reference<decltype(*from)>::value)
+            return count > 0 && _owns(std::addressof(*from));
+        return false;
     };
 
     /// also can throw exception according to index
@@ -204,50 +505,103 @@ private:
             throw std::runtime_error("Array exception: null pointer");
     };
 
-    /// Creates an array with allocate_ allocated memory
-    Array(const int& allocate_)
-        : allocated_(allocate_ + 20), left_buffer_(10), right_buffer_(10),
-          buffer_size_(10), data_(0) {
+    /// Creates an array with allocate_ uninitialized elements, they must be constructed by the caller
+    Array(const int& allocate_, const Allocator& allocator)
+        : buffer_size_(10), data_(0), allocator_(allocator) {
         _check_except_size(allocate_ + 1);
-        data_ = _alloc(allocated_);
+        _init_storage(allocate_);
+    };
+    /// Runs construct on elements left uninitialized by Array(allocate_, allocator).
+    /// If it throws they are given back to the right buffer, so the destructor only frees memory
+    template<typename Construct>
+    void _construct_storage(Construct construct) {
+        try {
+            construct();
+        } catch(...) {
+            right_buffer_ += size();
+            throw;
+        };
+    };
+
+    /// Takes memory and elements of other leaving it empty.
+    /// This array must hold no memory, allocators must be equal or already exchanged.
+    /// Inline elements can not change owner, so they are relocated
+    void _take_storage(Array& other) {
+        allocated_ = other.allocated_;
+        left_buffer_ = other.left_buffer_;
+        right_buffer_ = other.right_buffer_;
+        buffer_size_ = other.buffer_size_;
+        reserved_left_ = other.reserved_left_;
+        reserved_right_ = other.reserved_right_;
+        if(other._is_inline()) {
+            data_ = inline_.data();
+            _relocate(data_ + left_buffer_, other.data_ + left_buffer_, size());
+        } else
+            data_ = other.data_;
+
+        other.data_ = 0;
+        if constexpr(Inline > 0)
+            other._init_storage(0);
+        else
+            other.allocated_ = other.left_buffer_ = other.right_buffer_ = 0;
     };
 
 public:
     /// Creates an ampty array with buffer_size_ set to 10
-    Array() : Array(0) {};
-    /// Creates an array with size_ elements equal to default_member
-    Array(const int& size, const_reference default_member) : Array(size) {
-        auto iter = begin(),
-             last = end();
-
-        while(iter != last) {
-            *iter = default_member;
-            ++iter;
+    Array() : Array(0, Allocator()) {};
+    /// Array with memory of allocator.
+    /// If allocator keeps a stored array (e.g. FileAllocator of an existing file) it is taken as is
+    explicit Array(const Allocator& allocator) : buffer_size_(10), data_(0), allocator_(allocator) {
+        if constexpr(has_image<Allocator>::value) {
+            std::size_t allocated, left, count;
+            data_ = allocator_.load(allocated, left, count);
+            if(data_ != 0) {
+                if(allocated > std::size_t(std::numeric_limits<int>::max()))
+                    throw std::runtime_error("Array exception: stored array is too large");
+                allocated_ = int(allocated);
+                left_buffer_ = int(left);
+                right_buffer_ = allocated_ - left_buffer_ - int(count);
+                return;
+            };
         };
+        _init_storage(0);
     };
     /// Creates an array with size_ elements equal to default_member
-    Array(const int& size, const_pointer default_member) : Array(size, *default_member) {};
+    Array(const int& size, const_reference default_member, const Allocator& allocator = Allocator())
+        : Array(size, allocator) {
+        _construct_storage([&]() {
+            _construct_fill(data_ + left_buffer_, default_member, size);
+        });
+    };
+    /// Creates an array with size_ elements equal to default_member
+    Array(const int& size, const_pointer default_member, const Allocator& allocator = Allocator())
+        : Array(size, *default_member, allocator) {};
 
     /// Creates an array with copy of data
-    Array(const_pointer data, const int& count) : Array(count) {
-        _check_except_null_pointer(data, count - 1);
-        memcpy(data_, data, el_size() * count);
+    Array(const_pointer data, const int& count, const Allocator& allocator = Allocator())
+        : Array(count, allocator) {
+        _construct_storage([&]() {
+            _check_except_null_pointer(data, count - 1);
+            _construct_copies(data_ + left_buffer_, data, count);
+        });
     };
     /// Pointer copy constructor
-    Array(const Array* other) : Array(other->data_, other->size()) {};
+    Array(const Array* other)
+        : Array(other, alloc_traits::select_on_container_copy_construction(other->allocator_)) {};
+    /// Pointer copy constructor using another allocator
+    Array(const Array* other, const Allocator& allocator)
+        : Array(other->data_ + other->left_buffer_, other->size(), allocator) {};
     /// Reference copy constructor
     Array(const Array& other) : Array(&other) {};
+    Array(const Array& other, const Allocator& allocator) : Array(&other, allocator) {};
     /// Move constructor
-    Array(Array&& other) {
-        std::swap(allocated_, other.allocated_);
-        std::swap(left_buffer_, other.left_buffer_);
-        std::swap(right_buffer_, other.right_buffer_);
-        std::swap(buffer_size_, other.buffer_size_);
-        std::swap(data_, other.data_);
+    Array(Array&& other) : allocator_(std::move(other.allocator_)) {
+        _take_storage(other);
     };
 
     /// Copies elements of init_list into array
-    Array(const std::initializer_list<T>& list) : Array(list.begin(), list.end()) {};
+    Array(const std::initializer_list<T>& list, const Allocator& allocator = Allocator())
+        : Array(list.begin(), list.end(), -1, allocator) {};
     /*/// Creates array of size elements each of them initialized by func (like lambda)
     template<typename Function = int (&)(), typename ...Arguments,
              typename = typename std::enable_if<!std::is_same<Function, pointer>::value &&
@@ -269,27 +623,11 @@ public:
     /// ForwardIterator must allow prefix increment and dereferencing.
     /// Count is used if evaluating distance between iterators is slow else -1 is defaulted
     template<typename ForwardIterator>
-    Array(const ForwardIterator& from, const ForwardIterator& to, const int& count = -1) : Array() {
-        int count_ = 0;
-        if(count == -1) {
-            count_ = to - from;
-        } else {
-            count_ = count;
-            _check_except_size(count_);
-        };
-
-        allocated_ = count_ + 2 * buffer_size_;
-        data_ = _alloc(allocated_);
-
-        auto iter = from,
-             last = to;
-        auto input_iter = begin();
-
-        while(iter != last){
-            *input_iter = *iter;
-            ++iter;
-            ++input_iter;
-        };
+    Array(const ForwardIterator& from, const ForwardIterator& to, const int& count = -1,
+          const Allocator& allocator = Allocator()) : Array(allocator) {
+        if(count != -1)
+            _check_except_size(count);
+        _append_range(from, to, count);
     };
 
     /// Double Range constructor
@@ -297,8 +635,9 @@ public:
     /// Count is used if evaluating distance between iterators is slow else -1 is defaulted
     template<typename ForwardIterator1, typename ForwardIterator2 = ForwardIterator1>
     Array(const ForwardIterator1& from1, const ForwardIterator1& to1,
-          const ForwardIterator2& from2, const ForwardIterator2& to2, const int& count = -1)
-        : Array() {
+          const ForwardIterator2& from2, const ForwardIterator2& to2, const int& count = -1,
+          const Allocator& allocator = Allocator())
+        : Array(allocator) {
         int count_ = 0;
         if(count == -1) {
             count_ = to1 - from1;
@@ -308,26 +647,20 @@ public:
             _check_except_size(count_);
         };
 
-        allocated_ = count_ + 2 * buffer_size_;
-        data_ = _alloc(allocated_);
-
-        auto iter1 = from1,
-             last1 = to1;
-        auto iter2 = from2,
-             last2 = to2;
-        auto input = begin();
-
-        while(iter1 != last1){
-            *input = *iter1;
-            ++iter1;
-            ++input;
-        };
+        _grow_right(count_);
+        _append_range(from1, to1, 0);
+        _append_range(from2, to2, 0);
+    };
 
-        while(iter2 != last2){
-            *input = *iter2;
-            ++iter2;
-            ++input;
-        };
+    /// returns copy of the allocator
+    allocator_type get_allocator() const {
+        return allocator_;
+    };
+    /// Records layout of the array in its storage and writes dirty pages to disk.
+    /// Requires an Allocator keeping an image, e.g. FileAllocator
+    void sync() {
+        static_assert(has_image<Allocator>::value, "Array exception: storage of this array can not be synced");
+        allocator_.store(data_, left_buffer_, size(), true);
     };
 
     /// returns current amount of elements
@@ -347,7 +680,7 @@ public:
     const int& right_buffer() const {
         return right_buffer_;
     };
-    /// returns amount of elements array is increased by each extension of memory
+    /// returns least amount of elements array is increased by on each extension of memory
     const int& buffer_size() const{
         return buffer_size_;
     };
@@ -358,9 +691,11 @@ public:
 
     /// clears all memory
     void clear() {
-        _realloc_both(20);
-        allocated_;
-        left_buffer_ = right_buffer_ = 10;
+        _destroy(data_ + left_buffer_, size());
+        _free();
+        data_ = 0;
+        reserved_left_ = reserved_right_ = 0;
+        _init_storage(0);
     };
     bool empty() const {
         if(size() > 0)
@@ -371,14 +706,42 @@ public:
     void resize(const int& size_){
         _check_except_size(size_);
 
-        if(size_ >= allocated_)
-            _realloc_right(size_ + buffer_size_);
+        int diff = size_ - size();
+        if(diff >= 0) {
+            _grow_right(diff);
+            _construct_fill(data_ + allocated_ - right_buffer_, T(), diff);
+            right_buffer_ -= diff;
+        } else {
+            _destroy(data_ + left_buffer_ + size_, -diff);
+            right_buffer_ -= diff;
+        };
+    };
+    /// Makes at least front free slots on the left and back free slots on the right,
+    /// reallocating at most once. Automatic trimming keeps these buffers until shrink_to_fit()
+    void reserve(const int& front, const int& back) {
+        _check_except_size(front + 1);
+        _check_except_size(back + 1);
+        reserved_left_ = front;
+        reserved_right_ = back;
+        if(front <= left_buffer_ && back <= right_buffer_)
+            return;
 
-        if(size_ >= size()) {
-            T element = T();
-            push_back(element, size_);
-        } else
-            right_buffer_ += size_;
+        if(_is_inline() && left_buffer_ + right_buffer_ >= front + back)
+            _shift_to(front);
+        else
+            __alloc_checks_helper(std::max(front, left_buffer_), std::max(back, right_buffer_));
+    };
+    /// Releases all free slots on both sides and drops buffers requested by reserve().
+    /// Elements go back to inline memory if they fit
+    void shrink_to_fit() {
+        reserved_left_ = reserved_right_ = 0;
+        if(Inline > 0 && size() <= Inline) {
+            if(!_is_inline()) {
+                int left = (Inline - size()) / 2;
+                __alloc_checks_helper(left, Inline - size() - left);
+            };
+        } else if(left_buffer_ + right_buffer_ > 0)
+            __alloc_checks_helper(0, 0);
     };
     /// sets buffer size to a new value so that next reallocation will extend the buffer limit
     void set_buffer_size(const int& buffer_size__) {
@@ -391,6 +754,14 @@ public:
     void print() const{
         std::cout << *this;
     };
+#ifdef FORMAT_FD
+    /// Writes array as to_string() does straight to a file descriptor, e.g. of a dump file
+    void print(const int& fd, const int& members_in_line = -1, bool show_indexes = false) const{
+        format::Writer out(fd);
+        format::write_range(out, data_ + left_buffer_, size(), members_in_line, show_indexes);
+        out << '\n';
+    };
+#endif
 
     const_reference front() const{
         return *_get_ptr(0);
@@ -419,32 +790,19 @@ public:
             return;
         };
 
-        _check_except_index_insert(at_index);
-        _check_except_size(count);
         _check_except_size(from_index + 1);
-        _check_except_null_pointer(data + from_index, count - 1);
-
-        allocated_ += - right_buffer_ + buffer_size_ + count;
-        pointer tmp = _alloc(allocated_);
-
-        memcpy(tmp + left_buffer_, data_ + left_buffer_, el_size() * at_index);
-        memcpy(tmp + left_buffer_ + at_index, data + from_index, el_size() * count);
-        memcpy(tmp + left_buffer_ + at_index + count, data_ + left_buffer_ + at_index, el_size() * (size() - at_index));
-
-        free(data_);
-        data_ = tmp;
-        right_buffer_ = buffer_size_;
+        insert(data + from_index, at_index, count);
     };
 
     /// copies count data elements starting from from_index at index position in array
     void set(const int& index, const_pointer data, const int& count = 1, const int& from_index = 0){
         _check_except_size(from_index + 1);
         _check_except_index(index);
-        _check_except_index(index + count);
+        _check_except_index(index + count - 1);
         _check_except_size(count);
         _check_except_null_pointer(data + from_index, count - 1);
 
-        memcpy(data_ + left_buffer_ + index, data + from_index, el_size() * count);
+        std::copy(data + from_index, data + from_index + count, data_ + left_buffer_ + index);
     };
     void set(const int& index, const_reference data){
         set(index, &data);
@@ -479,7 +837,8 @@ public:
     value pop_back() {
         _check_except_index(0);
 
-        T result = back();
+        T result = std::move(back());
+        _destroy(data_ + allocated_ - right_buffer_ - 1, 1);
         right_buffer_ += 1;
 
         return result;
@@ -488,7 +847,8 @@ public:
     void pop_back(const int& count) {
         _check_except_size(size() - count);
 
-        right_buffer_ = count;
+        _destroy(data_ + allocated_ - right_buffer_ - count, count);
+        right_buffer_ += count;
         _dealloc_check();
     };
 
@@ -496,7 +856,8 @@ public:
     value pop_front() {
         _check_except_index(size() - 1);
 
-        T result = front();
+        T result = std::move(front());
+        _destroy(data_ + left_buffer_, 1);
         left_buffer_+= 1;
 
         return result;
@@ -505,6 +866,7 @@ public:
     void pop_front(const int& count) {
         _check_except_size(size() - count);
 
+        _destroy(data_ + left_buffer_, count);
         left_buffer_ += count;
         _dealloc_check();
     };
@@ -514,18 +876,24 @@ public:
         _check_except_size(from_index + 1);
         _check_except_size(count);
         _check_except_null_pointer(data + from_index, count - 1);
+        if(count > right_buffer_ && _owns(data + from_index)) {
+            // data would move away on reallocation
+            Array copy(data + from_index, count, allocator_);
+            push_back(copy.data_ + copy.left_buffer_, count);
+            return;
+        };
 
-        if(count > right_buffer_) {
-            _realloc_right(allocated_ - right_buffer_ + count + buffer_size_);
-            memcpy(data_ + allocated_ - right_buffer_, data + from_index, el_size() * count);
-            right_buffer_ = buffer_size_;
-        } else {
-            memcpy(data_ + allocated_ - right_buffer_, data + from_index, el_size() * count);
-            --right_buffer_;
-        }
+        _grow_right(count);
+        _construct_copies(data_ + allocated_ - right_buffer_, data + from_index, count);
+        right_buffer_ -= count;
     };
     void push_back(const_reference data){
-        push_back(&data);
+        if(right_buffer_ == 0 && _owns(&data)) {
+            // data would move away on reallocation
+            T copy = data;
+            push_back(&copy);
+        } else
+            push_back(&data);
     };
     /// Adds init_list contents to the end of array
     void push_back(const std::initializer_list<T>& list) {
@@ -534,29 +902,16 @@ public:
     /// add range to the end of array, count is used optinally if distance is known
     template<typename ForwardIterator>
     void push_back(ForwardIterator from, ForwardIterator to, const int& count = -1) {
-        int count_ = 0;
-        if(count == -1)
-            count_ = to - from;
-        else {
-            count_ = count;
-            _check_except_size(count_);
-        };
-
-        if(count_ > right_buffer_) {
-            _realloc_right(allocated_ - right_buffer_ + count_ + buffer_size_);
-            right_buffer_ = buffer_size_;
-        } else
-            right_buffer_ -= count_;
-
-        auto iter = from,
-             last = to;
-        auto input_iter = at(size() - count_);
-
-        while (iter != last) {
-            *input_iter = *iter;
-            ++iter;
-            ++input_iter;
+        if(count != -1)
+            _check_except_size(count);
+        int count_ = count == -1 ? int(to - from) : count;
+        if(count_ > right_buffer_ && _owns_range(from, count_)) {
+            // growing frees the range of this array
+            Array copy(from, to, count_, allocator_);
+            _append_range(copy.data_ + copy.left_buffer_, copy.data_ + copy.left_buffer_ + count_, count_);
+            return;
         };
+        _append_range(from, to, count_);
     };
 
     /// adds count data elements starting from from_index to the beginning of array
@@ -564,18 +919,22 @@ public:
         _check_except_size(from_index + 1);
         _check_except_size(count);
         _check_except_null_pointer(data + from_index, count - 1);
-
-        if(count > left_buffer_) {
-            _realloc_left(buffer_size_ + count + allocated_ - left_buffer_);
-            memcpy(data_ + buffer_size_, data + from_index, el_size() * count);
-            left_buffer_ = buffer_size_;
-        } else {
-            memcpy(data_ + left_buffer_ - 1, data + from_index, el_size() * count);
-            --left_buffer_;
+        if(count > left_buffer_ && _owns(data + from_index)) {
+            Array copy(data + from_index, count, allocator_);
+            push_front(copy.data_ + copy.left_buffer_, count);
+            return;
         };
+
+        _grow_left(count);
+        _construct_copies(data_ + left_buffer_ - count, data + from_index, count);
+        left_buffer_ -= count;
     };
     void push_front(const_reference data){
-        push_front(&data);
+        if(left_buffer_ == 0 && _owns(&data)) {
+            T copy = data;
+            push_front(&copy);
+        } else
+            push_front(&data);
     };
     /// Adds init_list contents to array
     void push_front(const std::initializer_list<T>& list) {
@@ -591,27 +950,22 @@ public:
             count_ = count;
             _check_except_size(count_);
         };
-
-        if(count_ > left_buffer_) {
-            _realloc_left(buffer_size_ + count_ + allocated_ - left_buffer_);
-            left_buffer_ = buffer_size_;
-        } else
-            left_buffer_ -= count_;
-
-        auto iter = from,
-             last = to;
-        auto input_iter = begin();
-
-        while (iter != to) {
-            *input_iter = *iter;
-            ++iter;
-            ++input_iter;
+        if(count_ > left_buffer_ && _owns_range(from, count_)) {
+            Array copy(from, to, count_, allocator_);
+            push_front(copy.data_ + copy.left_buffer_, count_);
+            return;
         };
+
+        _grow_left(count_);
+        _construct_copies(data_ + left_buffer_ - count_, from, count_);
+        left_buffer_ -= count_;
     };
 
     /// return index of data if it is found in array or -1
     int find_index(const_pointer data) const{
         _check_except_null_pointer(data);
+        if constexpr(array_simd::is_supported<T>::value)
+            return array_simd::find(data_ + left_buffer_, size(), *data);
 
         auto iter = begin(),
              last = end();
@@ -645,20 +999,10 @@ public:
 
     /// Returns iterator at position of data in array or end iterator
     iterator find_iterator(const_pointer data) {
-        _check_except_null_pointer(data);
-
-        iterator
-                iter = begin(),
-                last = end();
-
-        while(iter != last){
-            if(*iter == *data)
-                return iter;
-
-            ++iter;
-        };
-
-        return last;
+        int index = find_index(data);
+        if(index == -1)
+            return end();
+        return at(index);
     };
     iterator find_iterator(const_reference data) {
         return find_iterator(&data);
@@ -666,19 +1010,10 @@ public:
 
     /// Returns read-only iterator at position of data in array or end iterator
     const_iterator find_iterator(const_pointer data) const {
-        _check_except_null_pointer(data);
-
-        auto iter = cbegin(),
-             last = cend();
-
-        while(iter != last){
-            if(*iter == *data)
-                return iter;
-
-            ++iter;
-        };
-
-        return last;
+        int index = find_index(data);
+        if(index == -1)
+            return cend();
+        return cat(index);
     };
     const_iterator find_iterator(const_reference data) const {
         return find_iterator(&data);
@@ -692,7 +1027,7 @@ public:
              last = end();
         int index = 0;
 
-        while (iter != position || iter == last) {
+        while (iter != position && iter != last) {
             ++index;
             ++iter;
         };
@@ -713,15 +1048,8 @@ public:
         } else if(index == 0) {
             return pop_front();
         } else {
-            value result = *_get_ptr(index);
-
-            pointer tmp = _alloc(allocated_ - 1);
-            memcpy(tmp + left_buffer_, data_ + left_buffer_, el_size() * index);
-            memcpy(tmp + left_buffer_, data_ + left_buffer_ + index, el_size() * (size() - index - 1));
-            allocated_ -= 1;
-
-            free(data_);
-            data_ = tmp;
+            value result = std::move(*_get_ptr(index));
+            _close_gap(index, 1);
             return result;
         };
     };
@@ -731,7 +1059,7 @@ public:
     bool remove(const_pointer data){
         _check_except_null_pointer(data);
 
-        int index = find(data);
+        int index = find_index(data);
         if(index == -1)
             return false;
 
@@ -742,16 +1070,42 @@ public:
         return remove(&data);
     };
 
-    /// Deletes all copies of data in array
-    void remove_all(const_pointer data) {
+    /// Deletes all copies of data in array in one pass.
+    /// Returns amount of removed elements, memory is freed only if shrink is set
+    int remove_all(const_pointer data, const bool& shrink = false) {
         _check_except_null_pointer(data);
-        bool flag = true;
+        if(_owns(data)) {
+            // the element compared with may be overwritten while compacting
+            T copy = *data;
+            return remove_if([&copy](const_reference element) { return element == copy; }, shrink);
+        };
+        return remove_if([data](const_reference element) { return element == *data; }, shrink);
+    };
+    int remove_all(const_reference data, const bool& shrink = false) {
+        return remove_all(&data, shrink);
+    };
+    /// Deletes every element predicate is true for keeping order of the rest.
+    /// Elements are visited once and kept ones are moved towards the front in place.
+    /// Returns amount of removed elements, memory is freed only if shrink is set
+    template<typename Predicate>
+    int remove_if(Predicate predicate, const bool& shrink = false) {
+        pointer first = data_ + left_buffer_,
+                last = first + size(),
+                output = first;
+
+        for(pointer iter = first; iter != last; ++iter)
+            if(!predicate(*iter)) {
+                if(output != iter)
+                    *output = std::move(*iter);
+                ++output;
+            };
 
-        while (flag)
-            flag = remove(data);
-    };
-    bool remove_all(const_reference data) {
-        return remove_all(&data);
+        int removed = int(last - output);
+        _destroy(output, removed);
+        right_buffer_ += removed;
+        if(shrink)
+            _dealloc_check();
+        return removed;
     };
 
     /// Inserts data at index
@@ -764,18 +1118,12 @@ public:
             push_front(data, count);
         else if(index == size())
             push_back(data, count);
-        else {
-            pointer tmp = _alloc(allocated_ + count);
-
-            memcpy(tmp + left_buffer_, data_ + left_buffer_, index * el_size());
-            memcpy(tmp + left_buffer_ + index, data, el_size() * count);
-            memcpy(tmp + left_buffer_ + index + count, data_ + left_buffer_ + index, el_size() * (size() - index));
-
-            free(data_);
-            data_ = tmp;
-            allocated_ += count;
-            //right_buffer_ -= count;
-        };
+        else if(_owns(data)) {
+            // opening the gap shifts or frees the elements data points to
+            Array copy(data, count, allocator_);
+            _insert_copies(index, copy.data_ + copy.left_buffer_, count);
+        } else
+            _insert_copies(index, data, count);
     };
     void insert(const_reference data, const int& index){
         insert(&data, index);
@@ -796,36 +1144,32 @@ public:
         };
         _check_except_index_insert(at);
 
-        pointer tmp = _alloc(allocated_ + count_);
-        memcpy(tmp + left_buffer_, data_ + left_buffer_, el_size() * at);
-
-        auto iter = from,
-             last = to;
-        int index = at + left_buffer_;
-        for(; iter != last; ++index, ++iter)
-            *(tmp + index) = *iter;
-
-        memcpy(tmp + index, data_ + index - count_, el_size() * (size() - at));
-        free(data_);
-        data_ = tmp;
-
-        allocated_ += count_;
+        if(_owns_range(from, count_)) {
+            // range of this array is copied before the gap moves it
+            Array copy(from, to, count_, allocator_);
+            _insert_copies(at, copy.data_ + copy.left_buffer_, count_);
+            return;
+        };
+        _insert_copies(at, from, count_);
     };
     /// Inserts init_list contents into array at index
     void insert(const std::initializer_list<T>& list, const int& at) {
         insert(list.begin(), list.end(), at);
     };
-    /*/// Inserts contentds of array at index
+    /// Inserts contents of array at index, other may be this array
     void insert(const Array& other, const int& at) {
-        insert(other.data_, at, other.size_);
-    };*/
+        if(other.size() > 0)
+            insert(other.data_ + other.left_buffer_, at, other.size());
+        else
+            _check_except_index_insert(at);
+    };
 
     /// Concates array to the end of this
     void concate(const Array& other){
         concate(&other);
     };
     void concate(const Array* other) {
-        copy_from(other->data_, other->size());
+        copy_from(other->data_ + other->left_buffer_, other->size());
     };
     /// Concates init_list to the end of array
     void concate(const std::initializer_list<T>& list) {
@@ -841,7 +1185,7 @@ public:
     Array get_concated(const Array* other) {
         _check_except_null_pointer(other);
 
-        Array result = Array(this);
+        Array result = Array(this, allocator_);
         result.concate(other);
 
         return result;
@@ -851,7 +1195,7 @@ public:
     };
     /// Returns result of concatenation of init_list to array
     Array get_concated(const std::initializer_list<T>& list) {
-        Array result = Array(this);
+        Array result = Array(this, allocator_);
         result.concate(list);
 
         return result;
@@ -859,7 +1203,7 @@ public:
     /// Returns result of concatenation of range to array, count allows to skip evaluating distance between iterators
     template<typename ForwardIterator>
     Array get_concated(const ForwardIterator& from, const ForwardIterator& to, const int& count = -1) {
-        Array result = Array(this);
+        Array result = Array(this, allocator_);
         result.concate(from, to, count);
 
         return result;
@@ -871,24 +1215,24 @@ public:
         _check_except_index(from_index);
         _check_except_index(to_index);
 
-        return Array(data_ + from_index, to_index - from_index);
+        return Array(data_ + left_buffer_ + from_index, to_index - from_index, allocator_);
     };
     /// Returns subarray from from_iterator to to_iterator excluding to_iterator
     /// Works even if range is not from this array.
     /// Count allows to skip evaluating distance between iterators
     Array subarray(const const_iterator& from_iterator, const const_iterator& to_iterator, const int& count = -1) {
-        return Array(from_iterator, to_iterator, count);
+        return Array(from_iterator, to_iterator, count, allocator_);
     };
 
     /// Returns result of concatenating other to this
     Array operator+(const Array& other) const {
         return Array(begin(), end(), other.begin(),
-                     other.end(), size() + other.size());
+                     other.end(), size() + other.size(), allocator_);
     };
     /// Returns a copy of array with data added to it's back
     Array operator+(const_reference data) const {
-        Array result = Array(size() + 1);
-        result.set(result.size() - 1, data);
+        Array result = Array(this, allocator_);
+        result.push_back(data);
 
         return result;
     };
@@ -913,10 +1257,8 @@ public:
 
     /// Adds val to array's beginning
     friend Array operator+(const_reference val, const Array& array){
-        Array result = Array(1 + array.allocated_);
-
-        result.set(0, val);
-        result.set(1, array.begin(), array.end(), array.size());
+        Array result = Array(array, array.allocator_);
+        result.push_front(val);
 
         return result;
     };
@@ -949,29 +1291,50 @@ public:
         return !(*this == other);
     };
 
+    /// Copy assignment, elements are copied before anything of this array is released,
+    /// so a throwing copy leaves the array as it was
     const Array& operator=(const Array& other){
         if(this != &other){
-            clear();
-
-            buffer_size_ = other.buffer_size_;
-            allocated_ = other.allocated_;
-            left_buffer_ = other.left_buffer_;
-            right_buffer_ = other.right_buffer_;
-
-            data_ = _alloc(allocated_);
-            memcpy(data_ + left_buffer_, other.data_ + left_buffer_, el_size() * size());
+            constexpr bool propagate = alloc_traits::propagate_on_container_copy_assignment::value;
+            Array copy(&other, propagate ? other.allocator_ : allocator_);
+
+            _destroy(data_ + left_buffer_, size());
+            _free();
+            data_ = 0;
+            allocated_ = left_buffer_ = right_buffer_ = 0;
+            if constexpr(propagate)
+                allocator_ = other.allocator_;
+
+            if constexpr(has_image<Allocator>::value) {
+                // the stored block was released above, the copy is moved to it
+                buffer_size_ = other.buffer_size_;
+                _init_storage(copy.size());
+                _relocate(data_ + left_buffer_, copy.data_ + copy.left_buffer_, copy.size());
+                copy.right_buffer_ += copy.size();
+            } else {
+                _take_storage(copy);
+                buffer_size_ = other.buffer_size_;
+            };
         };
         return *this;
     };
     const Array& operator=(Array&& other){
-        using namespace std;
-        clear();
-
-        swap(buffer_size_, other.buffer_size_);
-        swap(allocated_, other.allocated_);
-        swap(data_, other.data_);
-        swap(left_buffer_, other.left_buffer_);
-        swap(right_buffer_, other.right_buffer_);
+        if(this == &other)
+            return *this;
+        _destroy(data_ + left_buffer_, size());
+        _free();
+        data_ = 0;
+        allocated_ = left_buffer_ = right_buffer_ = 0;
+
+        if constexpr(alloc_traits::propagate_on_container_move_assignment::value) {
+            std::swap(allocator_, other.allocator_);
+            _take_storage(other);
+        } else if(allocator_ == other.allocator_)
+            _take_storage(other);
+        else
+            // memory of other can not be freed by this allocator
+            _append_range(std::make_move_iterator(other.data_ + other.left_buffer_),
+                          std::make_move_iterator(other.data_ + other.allocated_ - other.right_buffer_));
 
         return *this;
     };
@@ -994,18 +1357,71 @@ public:
 
     /// Calls function for each element of array
     template<typename Function = void (&)(const T& element), typename ...Arguments,
-             typename = typename std::enable_if<!std::is_integral<Function>::value> >
+             typename = typename std::enable_if<!std::is_integral<Function>::value>::type>
     void operator()(Function function, Arguments... function_args) const {
-        for(auto element : *this)
-            function(element, function_args...);
+        for(const_pointer iter = data_ + left_buffer_, last = iter + size(); iter != last; ++iter)
+            function(*iter, function_args...);
     };
-    /// Calls function for each element of array
-    /// This function changes assigns new value to each member
+    /// Calls function for each element of array.
+    /// If function returns a value it is assigned to the element,
+    /// otherwise function may change the element through a reference
     template<typename Function = T (&)(const T& element), typename ...Arguments,
-             typename = typename std::enable_if<!std::is_integral<Function>::value> >
+             typename = typename std::enable_if<!std::is_integral<Function>::value>::type>
     void operator()(Function function, Arguments... function_args) {
-        for(auto element : *this)
-            element = function(element, function_args...);
+        _apply(data_ + left_buffer_, data_ + allocated_ - right_buffer_, function, function_args...);
+    };
+
+    /// Applies function to each element like operator() over several threads.
+    /// Elements are split in chunks starting at cache line boundaries so that threads
+    /// do not write to the same line, small arrays are processed by the calling thread.
+    /// 'threads' <= 0 means all hardware threads
+    template<typename Function>
+    void parallel_apply(Function function, int threads = 0) {
+        if(threads <= 0)
+            threads = int(std::thread::hardware_concurrency());
+        if(threads > size() / parallel_apply_run)
+            threads = size() / parallel_apply_run;
+        if(threads < 2) {
+            (*this)(function);
+            return;
+        };
+
+        pointer first = data_ + left_buffer_,
+                last = data_ + allocated_ - right_buffer_;
+        std::vector<pointer> bounds(threads + 1);
+        bounds[0] = first;
+        bounds[threads] = last;
+        for(int i = 1; i < threads; ++i) {
+            pointer bound = first + (long long)(size()) * i / threads;
+            if constexpr(64 % sizeof(T) == 0) {
+                std::size_t offset = reinterpret_cast<std::uintptr_t>(bound) % 64;
+                if(offset != 0)
+                    bound += (64 - offset) / sizeof(T);
+            };
+            bounds[i] = bound < last ? bound : last;
+        };
+
+        std::vector<std::exception_ptr> errors(threads);
+        std::vector<std::thread> workers;
+        for(int i = 1; i < threads; ++i)
+            workers.emplace_back([&bounds, &errors, i, function]() mutable {
+                try {
+                    _apply(bounds[i], bounds[i + 1], function);
+                } catch(...) {
+                    errors[i] = std::current_exception();
+                };
+            });
+        try {
+            _apply(bounds[0], bounds[1], function);
+        } catch(...) {
+            errors[0] = std::current_exception();
+        };
+        for(auto& worker : workers)
+            worker.join();
+
+        for(auto& error : errors)
+            if(error)
+                std::rethrow_exception(error);
     };
 
     reference operator[](const int& index){
@@ -1015,54 +1431,59 @@ public:
         return get(index);
     };
 
-    /*
-    std::string to_string(const int& members_in_line = 1, bool show_indexes = false, bool add_ws = false) const{
-        std::string result = " [ ";
-        if(size_ == 0)
-            return result + ']';
-        else {
-            for(int i = 0; i < size() - 1; ++i){
-                std::string tmp;
-                if(show_indexes)
-                    tmp += std::to_string(i) + ':';
-                tmp += std::to_string(get(i)) + ", ";
-                if(i != 0 && i % members_in_line == members_in_line - 1)
-                    tmp += "\n   ";
-                result += tmp;
-            };
-            if(show_indexes)
-                result += std::to_string(size_ - 1) + ':';
-            result += std::to_string(back()) + " ]";
+    /// Returns array as text like " [ 0:a, 1:b ]".
+    /// Lines hold members_in_line elements (all in one line if it is <= 0),
+    /// show_indexes prefixes elements with their indexes, add_ws appends a line break
+    std::string to_string(const int& members_in_line = -1, bool show_indexes = false, bool add_ws = false) const{
+        std::string result;
+        {
+            format::Writer out(result);
+            format::write_range(out, data_ + left_buffer_, size(), members_in_line, show_indexes);
             if(add_ws)
-                result += '\n';
+                out << '\n';
         };
         return result;
     };
     explicit operator std::string() const{
         return to_string(1, true);
-    };*/
-    /// Outstream support example: std::cout
+    };
+    /// Outstream support example: std::cout.
+    /// Numbers use std::to_chars while out has default formatting, otherwise
+    /// (std::hex, setprecision, setw...) elements are passed to out one by one
     friend std::ostream& operator<<(std::ostream& out, const Array& array){
-        out << " [ ";
-        if(array.size() != 0) {
-            auto iter = array.begin();
-            for(int i = 0; i < array.size() - 1; ++i, ++iter)
-                out << *iter << ", ";
-            out << array.back() << ' ';
-        };
-        out << "] ";
-
+        format::Writer writer(out);
+        format::write_range(writer, array.data_ + array.left_buffer_, array.size());
+        writer << ' ';
         return out;
     };
 
+    /// writes array in binary format (see _binary.hpp), elements go in one write
+    void save(std::ostream& out) const{
+        binary::write_header(out, sizeof(T), size());
+        binary::write(out, data_ + left_buffer_, size());
+    };
+    /// Replaces contents with an array written by save().
+    /// Elements are read straight into the right buffer, array is left empty if reading fails
+    void load(std::istream& in){
+        std::uint64_t count = binary::read_header(in, sizeof(T));
+        if(count > std::uint64_t(std::numeric_limits<int>::max()))
+            throw std::runtime_error("Array exception: stored array is too large");
+
+        _destroy(data_ + left_buffer_, size());
+        right_buffer_ += size();
+        _grow_right(int(count));
+        binary::read(in, data_ + left_buffer_, count);
+        right_buffer_ -= int(count);
+    };
+
     iterator begin(){
-        return iterator(_get_ptr(0));
+        return iterator(data_ + left_buffer_);
     };
     const_iterator begin() const{
         return cbegin();
     };
     const_iterator cbegin() const{
-        return const_iterator(_get_ptr(0));
+        return const_iterator(data_ + left_buffer_);
     };
 
     iterator at(const int& index){
@@ -1076,18 +1497,46 @@ public:
     };
 
     iterator end(){
-        return iterator(data_ + size());
+        return iterator(data_ + allocated_ - right_buffer_);
     };
     const_iterator end() const{
         return cend();
     };
     const_iterator cend() const{
-        return const_iterator(data_ + size());
+        return const_iterator(data_ + allocated_ - right_buffer_);
     };
 
     ~Array(){
-        free(data_);
+        if constexpr(has_image<Allocator>::value)
+            allocator_.store(data_, left_buffer_, size(), false);
+        _destroy(data_ + left_buffer_, size());
+        _free();
     };
 };
 
+/// Array keeping up to N elements inside of the object, larger arrays spill to the heap
+template<typename T, int N, typename Growth = GeometricGrowth<>, typename Allocator = std::allocator<T> >
+using SmallArray = Array<T, Growth, Allocator, N>;
+
+/// Array using a polymorphic memory resource, e.g. std::pmr::monotonic_buffer_resource.
+/// Named like the other aliases, a global pmr namespace would clash with std::pmr under using namespace std
+template<typename T, typename Growth = GeometricGrowth<> >
+using PmrArray = Array<T, Growth, std::pmr::polymorphic_allocator<T> >;
+
+/// Array with memory aligned to Alignment bytes, blocks of HugePageThreshold bytes
+/// and more are put on huge pages (see AlignedAllocator)
+template<typename T, std::size_t Alignment = 64, std::size_t HugePageThreshold = 0, typename Growth = GeometricGrowth<> >
+using AlignedArray = Array<T, Growth, AlignedAllocator<T, Alignment, HugePageThreshold> >;
+
+/// Array whose large blocks are anonymous mappings resized with mremap
+/// instead of being copied (see MmapAllocator)
+template<typename T, std::size_t Threshold = std::size_t(1) << 20, typename Growth = GeometricGrowth<> >
+using MmapArray = Array<T, Growth, MmapAllocator<T, Threshold> >;
+
+#ifdef ARRAY_MREMAP
+/// Array stored in a memory-mapped file, FileArray<T>(FileAllocator<T>(path)) opens it
+template<typename T, typename Growth = GeometricGrowth<> >
+using FileArray = Array<T, Growth, FileAllocator<T> >;
+#endif
+
 #endif // DYNAMICARRAY_H
@@ -0,0 +1,78 @@
+#ifndef ALIGNED_ALLOCATOR_HPP
+#define ALIGNED_ALLOCATOR_HPP
+#include <new>
+#include <cstddef>
+#include <type_traits>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+/// Allocator handing out memory aligned to Alignment bytes (a cache line by default).
+/// Memory is never zeroed, Array constructs every element before reading it.
+/// Blocks of at least HugePageThreshold bytes are aligned to huge pages and
+/// advised with madvise(MADV_HUGEPAGE) on Linux to cut TLB misses, 0 turns it off.
+/// The allocator is stateless, all instances are equal
+template<typename T, std::size_t Alignment = 64, std::size_t HugePageThreshold = 0>
+class AlignedAllocator {
+    static_assert(Alignment != 0 && (Alignment & (Alignment - 1)) == 0,
+                  "AlignedAllocator exception: alignment must be a power of 2");
+
+public:
+    using value_type = T;
+    using pointer = T*;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using propagate_on_container_move_assignment = std::true_type;
+    using is_always_equal = std::true_type;
+
+    template<typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment, HugePageThreshold>;
+    };
+
+    /// size of a transparent huge page
+    static constexpr std::size_t huge_page = std::size_t(1) << 21;
+
+private:
+    static constexpr std::size_t _base_alignment = Alignment > alignof(T) ? Alignment : alignof(T);
+
+    /// true if a block of 'bytes' is backed by huge pages
+    static constexpr bool _huge(const std::size_t& bytes) {
+        return HugePageThreshold != 0 && bytes >= HugePageThreshold;
+    };
+    /// alignment of a block, deallocate() finds the same one from the block size
+    static constexpr std::size_t _alignment(const std::size_t& bytes) {
+        return _huge(bytes) && huge_page > _base_alignment ? huge_page : _base_alignment;
+    };
+
+public:
+    AlignedAllocator() noexcept {};
+    template<typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment, HugePageThreshold>&) noexcept {};
+
+    pointer allocate(const size_type& count) {
+        if(count > size_type(-1) / sizeof(T))
+            throw std::bad_array_new_length();
+        std::size_t bytes = sizeof(T) * count;
+        void* memory = ::operator new(bytes, std::align_val_t(_alignment(bytes)));
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+        if(_huge(bytes))
+            // only advice, memory works the same if the kernel refuses
+            madvise(memory, bytes, MADV_HUGEPAGE);
+#endif
+        return static_cast<pointer>(memory);
+    };
+    void deallocate(pointer ptr, const size_type& count) noexcept {
+        ::operator delete(ptr, std::align_val_t(_alignment(sizeof(T) * count)));
+    };
+
+    bool operator==(const AlignedAllocator&) const noexcept {
+        return true;
+    };
+    bool operator!=(const AlignedAllocator&) const noexcept {
+        return false;
+    };
+};
+
+#endif // ALIGNED_ALLOCATOR_HPP
@@ -0,0 +1,201 @@
+#ifndef ARRAY_SIMD_HPP
+#define ARRAY_SIMD_HPP
+#include <cstddef>
+#include <type_traits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ARRAY_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+/// Search kernels for contiguous arithmetic data.
+/// AVX2 and SSE4.2 versions are picked at runtime by the CPU, others fall back to a scalar loop
+namespace array_simd {
+
+/// true for arithmetic types compared lane by lane (booleans and long double are left out)
+template<typename T>
+struct is_supported : std::integral_constant<bool,
+        std::is_arithmetic<T>::value && !std::is_same<T, bool>::value &&
+        (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8)> {};
+
+/// returns index of the first element equal to value or -1
+template<typename T>
+int find_scalar(const T* data, const int& count, const T& value) {
+    for(int i = 0; i < count; ++i)
+        if(data[i] == value)
+            return i;
+    return -1;
+};
+
+#ifdef ARRAY_SIMD_X86
+/// Broadcast, load and equality compare for one lane type.
+/// Comparisons give all ones in equal lanes so that byte masks work for every type
+template<typename T, bool = std::is_floating_point<T>::value, std::size_t = sizeof(T)>
+struct Lanes;
+
+template<typename T>
+struct Lanes<T, false, 1> {
+    __attribute__((target("avx2"))) static __m256i set256(const T& value) { return _mm256_set1_epi8(char(value)); };
+    __attribute__((target("avx2"))) static __m256i eq256(const T* data, const __m256i& value) {
+        return _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data)), value);
+    };
+    __attribute__((target("sse4.2"))) static __m128i set128(const T& value) { return _mm_set1_epi8(char(value)); };
+    __attribute__((target("sse4.2"))) static __m128i eq128(const T* data, const __m128i& value) {
+        return _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)), value);
+    };
+};
+template<typename T>
+struct Lanes<T, false, 2> {
+    __attribute__((target("avx2"))) static __m256i set256(const T& value) { return _mm256_set1_epi16(short(value)); };
+    __attribute__((target("avx2"))) static __m256i eq256(const T* data, const __m256i& value) {
+        return _mm256_cmpeq_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data)), value);
+    };
+    __attribute__((target("sse4.2"))) static __m128i set128(const T& value) { return _mm_set1_epi16(short(value)); };
+    __attribute__((target("sse4.2"))) static __m128i eq128(const T* data, const __m128i& value) {
+        return _mm_cmpeq_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)), value);
+    };
+};
+template<typename T>
+struct Lanes<T, false, 4> {
+    __attribute__((target("avx2"))) static __m256i set256(const T& value) { return _mm256_set1_epi32(int(value)); };
+    __attribute__((target("avx2"))) static __m256i eq256(const T* data, const __m256i& value) {
+        return _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data)), value);
+    };
+    __attribute__((target("sse4.2"))) static __m128i set128(const T& value) { return _mm_set1_epi32(int(value)); };
+    __attribute__((target("sse4.2"))) static __m128i eq128(const T* data, const __m128i& value) {
+        return _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)), value);
+    };
+};
+template<typename T>
+struct Lanes<T, false, 8> {
+    __attribute__((target("avx2"))) static __m256i set256(const T& value) { return _mm256_set1_epi64x((long long)(value)); };
+    __attribute__((target("avx2"))) static __m256i eq256(const T* data, const __m256i& value) {
+        return _mm256_cmpeq_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data)), value);
+    };
+    __attribute__((target("sse4.2"))) static __m128i set128(const T& value) { return _mm_set1_epi64x((long long)(value)); };
+    __attribute__((target("sse4.2"))) static __m128i eq128(const T* data, const __m128i& value) {
+        return _mm_cmpeq_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)), value);
+    };
+};
+template<>
+struct Lanes<float, true, 4> {
+    __attribute__((target("avx2"))) static __m256i set256(const float& value) {
+        return _mm256_castps_si256(_mm256_set1_ps(value));
+    };
+    __attribute__((target("avx2"))) static __m256i eq256(const float* data, const __m256i& value) {
+        return _mm256_castps_si256(_mm256_cmp_ps(_mm256_loadu_ps(data), _mm256_castsi256_ps(value), _CMP_EQ_OQ));
+    };
+    __attribute__((target("sse4.2"))) static __m128i set128(const float& value) {
+        return _mm_castps_si128(_mm_set1_ps(value));
+    };
+    __attribute__((target("sse4.2"))) static __m128i eq128(const float* data, const __m128i& value) {
+        return _mm_castps_si128(_mm_cmpeq_ps(_mm_loadu_ps(data), _mm_castsi128_ps(value)));
+    };
+};
+template<>
+struct Lanes<double, true, 8> {
+    __attribute__((target("avx2"))) static __m256i set256(const double& value) {
+        return _mm256_castpd_si256(_mm256_set1_pd(value));
+    };
+    __attribute__((target("avx2"))) static __m256i eq256(const double* data, const __m256i& value) {
+        return _mm256_castpd_si256(_mm256_cmp_pd(_mm256_loadu_pd(data), _mm256_castsi256_pd(value), _CMP_EQ_OQ));
+    };
+    __attribute__((target("sse4.2"))) static __m128i set128(const double& value) {
+        return _mm_castpd_si128(_mm_set1_pd(value));
+    };
+    __attribute__((target("sse4.2"))) static __m128i eq128(const double* data, const __m128i& value) {
+        return _mm_castpd_si128(_mm_cmpeq_pd(_mm_loadu_pd(data), _mm_castsi128_pd(value)));
+    };
+};
+
+/// 4 vectors of 32 bytes are compared per iteration, byte masks tell the matching lane
+template<typename T>
+__attribute__((target("avx2")))
+int find_avx2(const T* data, const int& count, const T& value) {
+    using lanes = Lanes<T>;
+    constexpr int step = 32 / sizeof(T);
+    const __m256i needle = lanes::set256(value);
+    int i = 0;
+
+    for(; i + 4 * step <= count; i += 4 * step) {
+        __m256i eq0 = lanes::eq256(data + i, needle);
+        __m256i eq1 = lanes::eq256(data + i + step, needle);
+        __m256i eq2 = lanes::eq256(data + i + 2 * step, needle);
+        __m256i eq3 = lanes::eq256(data + i + 3 * step, needle);
+        __m256i any = _mm256_or_si256(_mm256_or_si256(eq0, eq1), _mm256_or_si256(eq2, eq3));
+        if(_mm256_testz_si256(any, any))
+            continue;
+
+        const __m256i eqs[4] = {eq0, eq1, eq2, eq3};
+        for(int j = 0; j < 4; ++j) {
+            unsigned mask = unsigned(_mm256_movemask_epi8(eqs[j]));
+            if(mask != 0)
+                return i + j * step + __builtin_ctz(mask) / int(sizeof(T));
+        };
+    };
+    for(; i + step <= count; i += step) {
+        unsigned mask = unsigned(_mm256_movemask_epi8(lanes::eq256(data + i, needle)));
+        if(mask != 0)
+            return i + __builtin_ctz(mask) / int(sizeof(T));
+    };
+
+    int rest = find_scalar(data + i, count - i, value);
+    return rest < 0 ? -1 : i + rest;
+};
+
+/// 2 vectors of 16 bytes are compared per iteration
+template<typename T>
+__attribute__((target("sse4.2")))
+int find_sse42(const T* data, const int& count, const T& value) {
+    using lanes = Lanes<T>;
+    constexpr int step = 16 / sizeof(T);
+    const __m128i needle = lanes::set128(value);
+    int i = 0;
+
+    for(; i + 2 * step <= count; i += 2 * step) {
+        unsigned mask0 = unsigned(_mm_movemask_epi8(lanes::eq128(data + i, needle)));
+        unsigned mask1 = unsigned(_mm_movemask_epi8(lanes::eq128(data + i + step, needle)));
+        if((mask0 | mask1) == 0)
+            continue;
+        if(mask0 != 0)
+            return i + __builtin_ctz(mask0) / int(sizeof(T));
+        return i + step + __builtin_ctz(mask1) / int(sizeof(T));
+    };
+
+    int rest = find_scalar(data + i, count - i, value);
+    return rest < 0 ? -1 : i + rest;
+};
+
+/// 2 for AVX2, 1 for SSE4.2, 0 if only scalar code can be used
+inline int cpu_level() {
+    static const int level = [] {
+        __builtin_cpu_init();
+        if(__builtin_cpu_supports("avx2"))
+            return 2;
+        if(__builtin_cpu_supports("sse4.2"))
+            return 1;
+        return 0;
+    }();
+    return level;
+};
+#endif // ARRAY_SIMD_X86
+
+/// Returns index of the first element equal to value or -1.
+/// Uses the widest vectors the CPU supports
+template<typename T>
+int find(const T* data, const int& count, const T& value) {
+    static_assert(is_supported<T>::value, "array_simd exception: type is not supported");
+#ifdef ARRAY_SIMD_X86
+    switch(cpu_level()) {
+    case 2:
+        return find_avx2(data, count, value);
+    case 1:
+        return find_sse42(data, count, value);
+    };
+#endif
+    return find_scalar(data, count, value);
+};
+
+};
+
+#endif // ARRAY_SIMD_HPP
@@ -0,0 +1,425 @@
+#include "_array.hpp"
+#include <vector>
+#include <string>
+#include <sstream>
+#include <filesystem>
+#include <memory_resource>
+#include <algorithm>
+#include <random>
+#include <limits>
+#include "../_checks.hpp"
+
+using namespace std;
+using namespace checks;
+
+// elements of an array inserted into the same array, with and without spare buffers
+static void check_aliasing() {
+    for(int spare = 0; spare < 2; ++spare) {
+        Array<string> array;
+        vector<string> expected;
+        for(int i = 0; i < 50; ++i) {
+            array.push_back(to_string(i));
+            expected.push_back(to_string(i));
+        };
+        if(spare == 0)
+            array.shrink_to_fit();
+
+        array.insert(array[0], 3);
+        expected.insert(expected.begin() + 3, string(expected[0]));
+        check(same(array, expected), "insert of the array's own element");
+
+        array.shrink_to_fit();
+        array.insert(&array[40], 10, 5);
+        vector<string> part(expected.begin() + 40, expected.begin() + 45);
+        expected.insert(expected.begin() + 10, part.begin(), part.end());
+        check(same(array, expected), "insert of the array's own elements");
+
+        array.shrink_to_fit();
+        array.insert(array, 7);
+        part = expected;
+        expected.insert(expected.begin() + 7, part.begin(), part.end());
+        check(same(array, expected), "insert of the array into itself");
+
+        array.shrink_to_fit();
+        array.insert(&array[1], &array[4], 20);
+        part.assign(expected.begin() + 1, expected.begin() + 4);
+        expected.insert(expected.begin() + 20, part.begin(), part.end());
+        check(same(array, expected), "insert of the array's own range");
+
+        array.shrink_to_fit();
+        array.push_back(&array[0], 5);
+        part.assign(expected.begin(), expected.begin() + 5);
+        expected.insert(expected.end(), part.begin(), part.end());
+        check(same(array, expected), "push_back of the array's own elements");
+
+        array.shrink_to_fit();
+        array.push_front(&array[array.size() - 3], 3);
+        part.assign(expected.end() - 3, expected.end());
+        expected.insert(expected.begin(), part.begin(), part.end());
+        check(same(array, expected), "push_front of the array's own elements");
+
+        // ranges of iterators over the whole array, growing frees their memory
+        array.shrink_to_fit();
+        array.push_back(array.begin(), array.end());
+        part = expected;
+        expected.insert(expected.end(), part.begin(), part.end());
+        check(same(array, expected), "push_back of the array's own range");
+
+        array.shrink_to_fit();
+        array.concate(array.begin(), array.end());
+        part = expected;
+        expected.insert(expected.end(), part.begin(), part.end());
+        check(same(array, expected), "concate of the array's own range");
+
+        array.shrink_to_fit();
+        array.push_front(array.begin(), array.end());
+        part = expected;
+        expected.insert(expected.begin(), part.begin(), part.end());
+        check(same(array, expected), "push_front of the array's own range");
+
+        array.shrink_to_fit();
+        array.insert(array.at(2), array.at(9), array.size());
+        part.assign(expected.begin() + 2, expected.begin() + 9);
+        expected.insert(expected.end(), part.begin(), part.end());
+        check(same(array, expected), "insert of the array's own range at the end");
+    };
+
+    Array<int> numbers = { 1, 2, 3 };
+    numbers.shrink_to_fit();
+    numbers.push_back(numbers.begin(), numbers.end());
+    numbers.push_front(numbers.begin(), numbers.end());
+    check(same(numbers, vector<int>{ 1, 2, 3, 1, 2, 3, 1, 2, 3, 1, 2, 3 }), "own ranges of bitwise copied elements");
+};
+
+// geometric growth reallocates a logarithmic number of times, fixed growth every buffer_size pushes
+static void check_growth() {
+    Array<int> geometric;
+    Array<int, FixedGrowth> fixed;
+    const int* first = 0;
+    const int* fixed_first = 0;
+    int moves = 0, fixed_moves = 0;
+    bool bounded = true, fixed_bounded = true;
+    for(int i = 0; i < 20000; ++i) {
+        geometric.push_back(i);
+        fixed.push_back(i);
+        moves += &geometric.front() != first;
+        fixed_moves += &fixed.front() != fixed_first;
+        first = &geometric.front();
+        fixed_first = &fixed.front();
+        bounded = bounded && geometric.right_buffer() <= geometric.size() / 2 + 10;
+        fixed_bounded = fixed_bounded && fixed.right_buffer() <= 10;
+    };
+    check(moves <= 30 && bounded, "geometric growth of the right side");
+    check(fixed_moves >= 20000 / 11 && fixed_bounded, "fixed growth adds buffer_size slots");
+
+    const int* last = 0;
+    moves = 0;
+    for(int i = 0; i < 20000; ++i) {
+        geometric.push_front(-i);
+        moves += &geometric.back() != last;
+        last = &geometric.back();
+        bounded = bounded && geometric.left_buffer() <= geometric.size() / 2 + 10;
+    };
+    check(moves <= 30 && bounded, "geometric growth of the left side");
+    check(geometric.size() == 40000 && geometric[0] == -19999 && geometric[39999] == 19999,
+          "grown array keeps its elements");
+
+    fixed.set_buffer_size(1000);
+    fixed_moves = 0;
+    for(int i = 0; i < 5000; ++i) {
+        fixed.push_back(i);
+        fixed_moves += &fixed.front() != fixed_first;
+        fixed_first = &fixed.front();
+    };
+    check(fixed_moves <= 5, "fixed growth follows set_buffer_size");
+};
+
+/// find_index and every search kernel the CPU has against a linear scan,
+/// sizes cover full vector loops, single vectors and scalar tails
+template<typename T>
+static void check_find_of() {
+    mt19937 random(16);
+    for(int size = 0; size < 300; size += size < 70 ? 1 : 37) {
+        vector<T> values(size);
+        for(auto& element : values)
+            element = T(random() % 50);
+        Array<T> array(values.begin(), values.end());
+        for(int value = -1; value <= 50; ++value) {
+            int expected = int(find(values.begin(), values.end(), T(value)) - values.begin());
+            if(expected == size)
+                expected = -1;
+            check(array.find_index(T(value)) == expected, "find_index matches a linear scan");
+#ifdef ARRAY_SIMD_X86
+            if(array_simd::cpu_level() >= 1)
+                check(array_simd::find_sse42(values.data(), size, T(value)) == expected, "SSE4.2 search kernel");
+            if(array_simd::cpu_level() >= 2)
+                check(array_simd::find_avx2(values.data(), size, T(value)) == expected, "AVX2 search kernel");
+#endif
+        };
+    };
+};
+
+// vectorized find_index of every lane width, floating point compares like operator==
+static void check_find() {
+    check_find_of<char>();
+    check_find_of<short>();
+    check_find_of<int>();
+    check_find_of<long long>();
+    check_find_of<float>();
+    check_find_of<double>();
+
+    Array<double> array(64, 1.0);
+    array.push_back(numeric_limits<double>::quiet_NaN());
+    array.push_back(-0.0);
+    array.push_back(0.0);
+    check(array.find_index(0.0) == 65 && array.find_index(-0.0) == 65, "zeros of both signs are equal");
+    check(array.find_index(numeric_limits<double>::quiet_NaN()) == -1, "NaN is equal to nothing");
+};
+
+// remove_all and remove_if compact in one pass keeping order of the rest
+static void check_remove() {
+    mt19937 random(17);
+    vector<Counted> values(5000);
+    for(auto& element : values)
+        element.value = int(random() % 10);
+    const int before = Counted::live;
+    {
+        Array<Counted> array(values.begin(), values.end());
+        vector<Counted> expected = values;
+
+        int removed = array.remove_if([](const Counted& element) { return element.value % 3 == 0; });
+        int erased = int(expected.size());
+        expected.erase(remove_if(expected.begin(), expected.end(),
+                                 [](const Counted& element) { return element.value % 3 == 0; }), expected.end());
+        check(removed == erased - int(expected.size()) && same(array, expected), "remove_if matches std::remove_if");
+
+        // the element compared with belongs to the array and is overwritten while compacting
+        Counted value = array[0];
+        removed = array.remove_all(array[0]);
+        erased = int(expected.size());
+        expected.erase(remove(expected.begin(), expected.end(), value), expected.end());
+        check(removed == erased - int(expected.size()) && same(array, expected), "remove_all of the array's own element");
+        check(array.remove_all(Counted(42)) == 0 && same(array, expected), "remove_all of a missing value");
+        check(Counted::live == before + 2 * int(expected.size()) + 1, "removed elements are destroyed");
+
+        int size = array.size();
+        check(array.remove_if([](const Counted&) { return true; }, true) == size && array.size() == 0,
+              "remove_if of every element");
+        check(array.right_buffer() <= 4 * 10, "shrinking remove_if trims the freed side");
+    };
+    check(Counted::live == before, "arrays release their elements");
+};
+
+// operator() assigns results or lets functions change elements, parallel_apply visits each element once
+static void check_apply() {
+    Array<int> array = { 1, 2, 3, 4 };
+    array([](const int& element) { return element * 2; });
+    check(same(array, vector<int>{ 2, 4, 6, 8 }), "operator() assigns returned values");
+    array([](const int& element, int step) { return element + step; }, 5);
+    check(same(array, vector<int>{ 7, 9, 11, 13 }), "operator() passes its arguments");
+    array([](int& element) { --element; });
+    check(same(array, vector<int>{ 6, 8, 10, 12 }), "operator() lets functions change elements");
+    int sum = 0;
+    static_cast<const Array<int>&>(array)([&sum](const int& element) { sum += element; });
+    check(sum == 36, "const operator() visits every element");
+
+    for(int threads : { 0, 3, 4 }) {
+        Array<int> large;
+        for(int i = 0; i < 200001; ++i)
+            large.push_back(i);
+        large.push_front(-1);
+        large.parallel_apply([](const int& element) { return element * 3; }, threads);
+        large.parallel_apply([](int& element) { ++element; }, threads);
+        bool applied = true;
+        for(int i = 0; i < large.size(); ++i)
+            applied = applied && large[i] == (i - 1) * 3 + 1;
+        check(applied, "parallel_apply visits every element once");
+    };
+
+    // the last chunk goes to a worker thread
+    Array<int> failing(100000, 1);
+    failing[99999] = 0;
+    check(throws([&]() {
+        failing.parallel_apply([](const int& element) {
+            if(element == 0)
+                throw std::runtime_error("Apply exception: zero element");
+        }, 4);
+    }), "parallel_apply rethrows errors of its threads");
+};
+
+// reserved buffers survive pushes and pops, automatic trimming neither oscillates nor keeps too much
+static void check_reserve() {
+    Array<int> array = { 0 };
+    array.reserve(100, 1000);
+    check(array.left_buffer() >= 100 && array.right_buffer() >= 1000, "reserve makes room on both sides");
+    const int* first = &array[0];
+    for(int i = 1; i <= 1000; ++i)
+        array.push_back(i);
+    for(int i = 1; i <= 100; ++i)
+        array.push_front(-i);
+    check(&array[100] == first, "pushes into reserved buffers do not reallocate");
+    array.pop_back(1000);
+    array.pop_front(100);
+    check(array.left_buffer() >= 100 && array.right_buffer() >= 1000, "pops keep reserved buffers");
+    array.shrink_to_fit();
+    check(array.left_buffer() == 0 && array.right_buffer() == 0 && array.size() == 1 && array[0] == 0,
+          "shrink_to_fit releases every free slot");
+
+    for(int i = 1; i < 100000; ++i)
+        array.push_back(i);
+    array.shrink_to_fit();
+    // memory may be resized in place, so changes of capacity are counted
+    int capacity = array.size(), changes = 0;
+    auto count_change = [&]() {
+        int current = array.left_buffer() + array.size() + array.right_buffer();
+        changes += current != capacity;
+        capacity = current;
+    };
+    for(int i = 0; i < 10000; ++i) {
+        array.push_back(i);
+        count_change();
+        array.push_back(i);
+        array.pop_back(2);
+        count_change();
+    };
+    check(changes <= 1, "pushes and pops at the edge of capacity do not reallocate every time");
+
+    array.pop_back(90000);
+    check(array.right_buffer() <= 2 * array.size() + 40, "pops trim a side holding too many free slots");
+};
+
+// copies failing in the middle of filling elements leave nothing behind
+static void check_exception_safety() {
+    vector<Counted> values(20);
+    for(int i = 0; i < 20; ++i)
+        values[i].value = i;
+    const int before = Counted::live;
+
+    Counted::throw_after = 3;
+    check(throws([&]() { Array<Counted> array(10, values[0]); }), "fill constructor rethrows");
+    check(Counted::live == before, "fill constructor releases built elements");
+
+    Counted::throw_after = 5;
+    check(throws([&]() { Array<Counted> array(values.data(), 20); }), "buffer constructor rethrows");
+    check(Counted::live == before, "buffer constructor releases built elements");
+
+    Counted::throw_after = 10;
+    check(throws([&]() { Array<Counted> array(values.begin(), values.end()); }), "range constructor rethrows");
+    check(Counted::live == before, "range constructor releases built elements");
+
+    Array<Counted> array(values.data(), 10);
+    vector<Counted> expected(values.begin(), values.begin() + 10);
+    Counted::throw_after = 4;
+    check(throws([&]() { array.insert(values.data() + 10, 5, 8); }), "insert rethrows");
+    check(same(array, expected), "insert closes its gap");
+
+    Counted::throw_after = 4;
+    check(throws([&]() { array.push_back(values.data() + 10, 8); }), "push_back rethrows");
+    check(same(array, expected), "push_back leaves the array unchanged");
+
+    Counted::throw_after = 4;
+    check(throws([&]() { array.push_front(values.data() + 10, 8); }), "push_front rethrows");
+    check(same(array, expected), "push_front leaves the array unchanged");
+    check(Counted::live == before + 20, "failed copies are destroyed");
+
+    Array<Counted> source(values.data() + 5, 15);
+    Counted::throw_after = 6;
+    check(throws([&]() { array = source; }), "copy assignment rethrows");
+    check(same(array, expected), "failed copy assignment leaves the array unchanged");
+    check(Counted::live == before + 35, "failed copy assignment destroys its copies");
+    array = source;
+    check(same(array, vector<Counted>(values.begin() + 5, values.end())), "copy assignment");
+};
+
+// arrays written by save() or kept in a file come back as they were
+static void check_persistence() {
+    Array<long> array;
+    vector<long> expected;
+    for(long i = 0; i < 100000; ++i) {
+        array.push_back(i * i - 7);
+        expected.push_back(i * i - 7);
+    };
+
+    stringstream stream;
+    array.save(stream);
+    Array<long> loaded = { 1, 2, 3 };
+    loaded.load(stream);
+    check(same(loaded, expected), "save and load round trip");
+
+    stringstream empty;
+    Array<long>().save(empty);
+    loaded.load(empty);
+    check(loaded.size() == 0, "round trip of an empty array");
+
+    stream.clear();
+    stream.seekg(0);
+    Array<int> other;
+    check(throws([&]() { other.load(stream); }), "load refuses elements of another size");
+
+#ifdef ARRAY_MREMAP
+    const string path = (filesystem::temp_directory_path() / "MyArrayChecks.bin").string();
+    filesystem::remove(path);
+    {
+        FileArray<long> stored{FileAllocator<long>(path)};
+        for(long i = 0; i < 1000; ++i)
+            stored.push_front(-i);
+        stored.push_back(array.begin(), array.end());
+        stored.sync();
+    };
+    expected.insert(expected.begin(), 1000, 0);
+    for(long i = 0; i < 1000; ++i)
+        expected[i] = i - 999;
+    {
+        FileArray<long> reopened{FileAllocator<long>(path)};
+        check(same(reopened, expected), "FileArray reopens its elements");
+        reopened.push_back(42);
+    };
+    expected.push_back(42);
+    {
+        FileArray<long> read_only{FileAllocator<long>(path, true)};
+        check(same(read_only, expected), "FileArray keeps changes made after reopening");
+        read_only[0] = 7;
+    };
+    {
+        FileArray<long> reopened{FileAllocator<long>(path, true)};
+        check(reopened[0] == -999, "read-only FileArray does not change its file");
+    };
+    {
+        FileArray<long> assigned{FileAllocator<long>(path)};
+        FileArray<long> small = { 3, 2, 1 };
+        assigned = small;
+    };
+    {
+        FileArray<long> reopened{FileAllocator<long>(path)};
+        check(same(reopened, vector<long>{ 3, 2, 1 }), "FileArray keeps an array assigned to it");
+    };
+    check(throws([&]() { FileArray<int> wrong{FileAllocator<int>(path)}; }), "FileArray refuses a file of another type");
+    filesystem::remove(path);
+#endif
+};
+
+// PmrArray takes its memory from the resource it is given
+static void check_memory_resource() {
+    char buffer[1 << 12];
+    pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), pmr::null_memory_resource());
+    PmrArray<int> array(&arena);
+    for(int i = 0; i < 100; ++i)
+        array.push_back(i);
+    check(array.size() == 100 && array[99] == 99, "PmrArray keeps its elements");
+    const char* element = reinterpret_cast<const char*>(&array[0]);
+    check(element >= buffer && element < buffer + sizeof(buffer), "PmrArray allocates from its resource");
+};
+
+int main() {
+    return run([]() {
+        check_aliasing();
+        check_growth();
+        check_find();
+        check_remove();
+        check_apply();
+        check_reserve();
+        check_exception_safety();
+        check_persistence();
+        check_memory_resource();
+    });
+};
@@ -0,0 +1,257 @@
+#ifndef FILE_ALLOCATOR_HPP
+#define FILE_ALLOCATOR_HPP
+#include <new>
+#include <memory>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include "mmap_allocator.hpp"
+
+#ifdef ARRAY_MREMAP
+#include <fcntl.h>
+#include <sys/stat.h>
+
+/// Allocator keeping one block of an Array in a memory-mapped file.
+/// The file holds a header page with the layout of the array followed by its elements,
+/// so opening an existing file maps the stored array without reading or copying it.
+/// Growing resizes the file with ftruncate and the mapping with mremap.
+/// Read-only files are mapped copy-on-write: processes share their clean pages and
+/// changes never reach the file, growing copies the array to anonymous memory.
+/// Only the first block goes to the file, others (temporaries, copies) and every block
+/// of an allocator without a file come from MmapAllocator.
+/// Copies of an allocator share its file
+template<typename T, std::size_t Threshold = std::size_t(1) << 20>
+class FileAllocator {
+    static_assert(std::is_trivially_copyable<T>::value, "FileAllocator exception: elements must be trivially copyable");
+
+public:
+    using value_type = T;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
+
+    template<typename U>
+    struct rebind {
+        using other = FileAllocator<U, Threshold>;
+    };
+
+private:
+    using anonymous = MmapAllocator<T, Threshold>;
+
+    /// first bytes of the file, the rest of the first page is unused
+    struct Header {
+        char magic[8];
+        std::uint64_t element_size;
+        std::uint64_t allocated;
+        std::uint64_t left;
+        std::uint64_t size;
+    };
+    static constexpr char _magic[8] = "ARRAY01";
+
+    /// File and its mapping, shared by copies of the allocator
+    struct State {
+        int fd = -1;
+        bool read_only = false;
+        /// mapping of the header and elements
+        unsigned char* base = 0;
+        std::size_t length = 0;
+        /// elements are handed out to an array
+        bool live = false;
+
+        void unmap() noexcept {
+            if(base != 0)
+                munmap(base, length);
+            base = 0;
+            length = 0;
+            live = false;
+        };
+
+        ~State() {
+            unmap();
+            if(fd >= 0)
+                close(fd);
+        };
+    };
+
+    std::shared_ptr<State> _state;
+
+    static std::size_t _page() {
+        static const std::size_t page = std::size_t(sysconf(_SC_PAGESIZE));
+        return page;
+    };
+    /// file length holding count elements
+    static std::size_t _length(const size_type& count) {
+        if(count > (size_type(-1) - 2 * _page()) / sizeof(T))
+            throw std::bad_array_new_length();
+        return _page() + (sizeof(T) * count + _page() - 1) / _page() * _page();
+    };
+
+    Header* _header() const {
+        return reinterpret_cast<Header*>(_state->base);
+    };
+    pointer _data() const {
+        return reinterpret_cast<pointer>(_state->base + _page());
+    };
+    /// true if ptr is the block stored in the file
+    bool _owns(const_pointer ptr) const {
+        return _state && _state->live && ptr == _data();
+    };
+
+    void _map(const std::size_t& length) {
+        int flags = _state->read_only ? MAP_PRIVATE : MAP_SHARED;
+        void* memory = mmap(0, length, PROT_READ | PROT_WRITE, flags, _state->fd, 0);
+        if(memory == MAP_FAILED)
+            throw std::runtime_error("FileAllocator exception: can not map file");
+        _state->base = static_cast<unsigned char*>(memory);
+        _state->length = length;
+    };
+    void _resize_file(const std::size_t& length) {
+        if(ftruncate(_state->fd, off_t(length)) != 0)
+            throw std::runtime_error("FileAllocator exception: can not resize file");
+    };
+
+public:
+    /// allocator without a file
+    FileAllocator() noexcept {};
+    /// Opens path or creates it if it does not exist.
+    /// A stored array is mapped right away and handed to the array built with this allocator.
+    /// Files that hold no array of T are refused
+    explicit FileAllocator(const std::string& path, const bool& read_only = false)
+        : _state(std::make_shared<State>()) {
+        _state->read_only = read_only;
+        _state->fd = open(path.c_str(), read_only ? O_RDONLY : O_RDWR | O_CREAT, 0644);
+        if(_state->fd < 0)
+            throw std::runtime_error("FileAllocator exception: can not open " + path);
+
+        struct stat info;
+        if(fstat(_state->fd, &info) != 0)
+            throw std::runtime_error("FileAllocator exception: can not read " + path);
+        if(info.st_size == 0) {
+            if(read_only)
+                throw std::runtime_error("FileAllocator exception: " + path + " is empty");
+            return;
+        };
+        if(std::size_t(info.st_size) < _page())
+            throw std::runtime_error("FileAllocator exception: " + path + " holds no array");
+
+        _map(std::size_t(info.st_size));
+        const Header& header = *_header();
+        if(std::memcmp(header.magic, _magic, sizeof(_magic)) != 0 || header.element_size != sizeof(T) ||
+           header.left + header.size > header.allocated || _length(header.allocated) > _state->length) {
+            _state->unmap();
+            throw std::runtime_error("FileAllocator exception: " + path + " holds no array of this type");
+        };
+    };
+    template<typename U>
+    FileAllocator(const FileAllocator<U, Threshold>&) noexcept {};
+
+    /// copied arrays are kept in memory
+    FileAllocator select_on_container_copy_construction() const noexcept {
+        return FileAllocator();
+    };
+
+    /// The first block goes to the file replacing whatever it held, others are anonymous
+    pointer allocate(const size_type& count) {
+        if(!_state || _state->read_only || _state->live)
+            return anonymous().allocate(count);
+
+        std::size_t length = _length(count);
+        _state->unmap();
+        _resize_file(length);
+        _map(length);
+
+        Header* header = _header();
+        std::memcpy(header->magic, _magic, sizeof(_magic));
+        header->element_size = sizeof(T);
+        header->allocated = count;
+        header->left = header->size = 0;
+        _state->live = true;
+        return _data();
+    };
+    /// unmaps the file block, the file keeps its contents
+    void deallocate(pointer ptr, const size_type& count) noexcept {
+        if(_owns(ptr)) {
+            _state->unmap();
+            return;
+        };
+        anonymous().deallocate(ptr, count);
+    };
+    /// Resizes a block keeping its bytes, the file block is resized together with the file
+    pointer reallocate(pointer ptr, const size_type& old_count, const size_type& new_count) {
+        if(!_owns(ptr))
+            return anonymous().reallocate(ptr, old_count, new_count);
+
+        if(_state->read_only) {
+            pointer tmp = anonymous().allocate(new_count);
+            std::memcpy(static_cast<void*>(tmp), static_cast<const void*>(ptr),
+                        sizeof(T) * (old_count < new_count ? old_count : new_count));
+            _state->unmap();
+            return tmp;
+        };
+
+        std::size_t length = _length(new_count);
+        if(length > _state->length)
+            _resize_file(length);
+        void* memory = mremap(_state->base, _state->length, length, MREMAP_MAYMOVE);
+        if(memory == MAP_FAILED)
+            throw std::bad_alloc();
+        if(length < _state->length)
+            // a failure only leaves the file longer than needed
+            (void)ftruncate(_state->fd, off_t(length));
+
+        _state->base = static_cast<unsigned char*>(memory);
+        _state->length = length;
+        _header()->allocated = new_count;
+        return _data();
+    };
+
+    /// Hands out the block stored in the file with its layout, 0 if there is none
+    pointer load(size_type& allocated, size_type& left, size_type& size) {
+        if(!_state || _state->live || _state->base == 0)
+            return 0;
+        const Header& header = *_header();
+        allocated = size_type(header.allocated);
+        left = size_type(header.left);
+        size = size_type(header.size);
+        _state->live = true;
+        return _data();
+    };
+    /// Records layout of the file block, with flush dirty pages are written to disk before returning
+    void store(const_pointer data, const size_type& left, const size_type& size, const bool& flush) {
+        if(!_owns(data))
+            return;
+        _header()->left = left;
+        _header()->size = size;
+        if(flush && !_state->read_only && msync(_state->base, _state->length, MS_SYNC) != 0)
+            throw std::runtime_error("FileAllocator exception: can not sync file");
+    };
+
+    /// allocators sharing a file are equal
+    bool operator==(const FileAllocator& other) const noexcept {
+        return _state == other._state;
+    };
+    bool operator!=(const FileAllocator& other) const noexcept {
+        return !(*this == other);
+    };
+};
+#endif // ARRAY_MREMAP
+
+/// true if Allocator keeps an array image that can be loaded and stored
+template<typename Allocator, typename = void>
+struct has_image : std::false_type {};
+template<typename Allocator>
+struct has_image<Allocator, std::void_t<decltype(std::declval<Allocator&>().load(
+                                            std::declval<std::size_t&>(), std::declval<std::size_t&>(), std::declval<std::size_t&>())),
+                                        decltype(std::declval<Allocator&>().store(
+                                            std::declval<const typename Allocator::value_type*>(), std::size_t(0), std::size_t(0), true))> >
+        : std::true_type {};
+
+#endif // FILE_ALLOCATOR_HPP
@@ -0,0 +1,32 @@
+#ifndef GROWTH_POLICY_HPP
+#define GROWTH_POLICY_HPP
+
+/// Growth policies tell Array how many spare slots to leave on the side it extends.
+/// spare(size, buffer_size) is the slack added on top of the slots actually needed,
+/// sides with much more slack than that are trimmed after removals
+
+/// Extends a side by a fraction of current size (Numerator / Denominator - 1),
+/// so that pushes to either end are amortized O(1). Never less than buffer_size
+template<int Numerator = 3, int Denominator = 2>
+struct GeometricGrowth {
+    static_assert(Numerator > Denominator && Denominator > 0, "GeometricGrowth exception: factor must be greater than 1");
+
+    static int spare(const int& size, const int& buffer_size) {
+        long long result = (long long)(size) * (Numerator - Denominator) / Denominator;
+        if(result < buffer_size)
+            return buffer_size;
+        if(result > (1 << 30))
+            return 1 << 30;
+        return int(result);
+    };
+};
+
+/// Extends a side by buffer_size slots every time.
+/// Every push past the buffer copies the whole array
+struct FixedGrowth {
+    static int spare(const int&, const int& buffer_size) {
+        return buffer_size;
+    };
+};
+
+#endif // GROWTH_POLICY_HPP
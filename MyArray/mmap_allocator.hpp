@@ -0,0 +1,138 @@
+#ifndef MMAP_ALLOCATOR_HPP
+#define MMAP_ALLOCATOR_HPP
+#include <new>
+#include <cstdlib>
+#include <cstring>
+#include <cstddef>
+#include <utility>
+#include <type_traits>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define ARRAY_MREMAP 1
+#endif
+
+/// Allocator that can resize a block without copying it.
+/// Blocks of at least Threshold bytes are anonymous page-aligned mappings and
+/// reallocate() grows or shrinks them with mremap(MREMAP_MAYMOVE), so the kernel
+/// moves page table entries instead of bytes and peak memory does not double.
+/// Smaller blocks come from malloc and are resized with realloc.
+/// reallocate() copies bytes, Array uses it only for trivially relocatable types.
+/// Without mremap (not Linux) every block is handled by malloc and realloc.
+/// The allocator is stateless, all instances are equal
+template<typename T, std::size_t Threshold = std::size_t(1) << 20>
+class MmapAllocator {
+public:
+    using value_type = T;
+    using pointer = T*;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using propagate_on_container_move_assignment = std::true_type;
+    using is_always_equal = std::true_type;
+
+    template<typename U>
+    struct rebind {
+        using other = MmapAllocator<U, Threshold>;
+    };
+
+private:
+    static_assert(alignof(T) <= alignof(std::max_align_t), "MmapAllocator exception: over-aligned types are not supported");
+
+    static std::size_t _bytes(const size_type& count) {
+        if(count > size_type(-1) / sizeof(T))
+            throw std::bad_array_new_length();
+        return sizeof(T) * count;
+    };
+
+#ifdef ARRAY_MREMAP
+    static bool _mapped(const std::size_t& bytes) {
+        return bytes >= Threshold && bytes > 0;
+    };
+    /// mappings are made of whole pages
+    static std::size_t _pages(const std::size_t& bytes) {
+        static const std::size_t page = std::size_t(sysconf(_SC_PAGESIZE));
+        return (bytes + page - 1) / page * page;
+    };
+#else
+    static bool _mapped(const std::size_t&) {
+        return false;
+    };
+#endif
+
+public:
+    MmapAllocator() noexcept {};
+    template<typename U>
+    MmapAllocator(const MmapAllocator<U, Threshold>&) noexcept {};
+
+    pointer allocate(const size_type& count) {
+        std::size_t bytes = _bytes(count);
+        void* memory;
+#ifdef ARRAY_MREMAP
+        if(_mapped(bytes)) {
+            memory = mmap(0, _pages(bytes), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if(memory == MAP_FAILED)
+                throw std::bad_alloc();
+            return static_cast<pointer>(memory);
+        };
+#endif
+        memory = std::malloc(bytes > 0 ? bytes : 1);
+        if(memory == 0)
+            throw std::bad_alloc();
+        return static_cast<pointer>(memory);
+    };
+    void deallocate(pointer ptr, const size_type& count) noexcept {
+#ifdef ARRAY_MREMAP
+        std::size_t bytes = sizeof(T) * count;
+        if(_mapped(bytes)) {
+            munmap(ptr, _pages(bytes));
+            return;
+        };
+#endif
+        std::free(ptr);
+    };
+
+    /// Resizes a block of old_count objects to new_count objects keeping its bytes.
+    /// The block may move, on failure it is left untouched and std::bad_alloc is thrown
+    pointer reallocate(pointer ptr, const size_type& old_count, const size_type& new_count) {
+        std::size_t old_bytes = _bytes(old_count), new_bytes = _bytes(new_count);
+        bool old_mapped = _mapped(old_bytes), new_mapped = _mapped(new_bytes);
+
+        if(!old_mapped && !new_mapped) {
+            void* memory = std::realloc(ptr, new_bytes > 0 ? new_bytes : 1);
+            if(memory == 0)
+                throw std::bad_alloc();
+            return static_cast<pointer>(memory);
+        };
+#ifdef ARRAY_MREMAP
+        if(old_mapped && new_mapped) {
+            void* memory = mremap(ptr, _pages(old_bytes), _pages(new_bytes), MREMAP_MAYMOVE);
+            if(memory == MAP_FAILED)
+                throw std::bad_alloc();
+            return static_cast<pointer>(memory);
+        };
+#endif
+        // block crosses Threshold, it moves between malloc and a mapping
+        pointer tmp = allocate(new_count);
+        std::memcpy(static_cast<void*>(tmp), static_cast<const void*>(ptr), old_bytes < new_bytes ? old_bytes : new_bytes);
+        deallocate(ptr, old_count);
+        return tmp;
+    };
+
+    bool operator==(const MmapAllocator&) const noexcept {
+        return true;
+    };
+    bool operator!=(const MmapAllocator&) const noexcept {
+        return false;
+    };
+};
+
+/// true if Allocator can resize a block with reallocate(ptr, old_count, new_count)
+template<typename Allocator, typename = void>
+struct has_reallocate : std::false_type {};
+template<typename Allocator>
+struct has_reallocate<Allocator, std::void_t<decltype(std::declval<Allocator&>().reallocate(
+        std::declval<typename Allocator::value_type*>(), std::size_t(1), std::size_t(1)))> >
+        : std::true_type {};
+
+#endif // MMAP_ALLOCATOR_HPP
@@ -0,0 +1,465 @@
+#ifndef DEQUE_HPP
+#define DEQUE_HPP
+#include <new>
+#include <memory>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <type_traits>
+#include <initializer_list>
+#include "deque_iterator.hpp"
+#include "../_format.hpp"
+
+/// Elements in one chunk: a power of 2 of at least 16 elements and about 4 KiB
+constexpr int default_deque_chunk(const std::size_t& element_size) {
+    int chunk = 16;
+    while(chunk * element_size < 4096)
+        chunk *= 2;
+    return chunk;
+};
+
+/// Double-ended queue made of fixed-size chunks.
+/// Chunk pointers are kept in a map with free slots on both sides like the
+/// buffers of Array, so pushes and pops at either end never move elements:
+/// references stay valid until their element is removed.
+/// Running out of map slots recenters or reallocates only the chunk pointers.
+/// One emptied chunk is kept for reuse so pushing and popping across a chunk border
+/// does not allocate every time
+template<typename T, int Chunk = default_deque_chunk(sizeof(T)), typename Allocator = std::allocator<T> >
+class Deque {
+    static_assert(Chunk > 0 && (Chunk & (Chunk - 1)) == 0, "Deque exception: chunk size must be a power of 2");
+
+public:
+    using iterator = DequeIterator<T, Chunk>;
+    using const_iterator = DequeIterator<const T, Chunk>;
+    using allocator_type = Allocator;
+
+private:
+    using pointer = T*;
+    using const_pointer = const T*;
+    using reference = T&;
+    using const_reference = const T&;
+    using value = T;
+    using alloc_traits = std::allocator_traits<Allocator>;
+    using map_allocator = typename alloc_traits::template rebind_alloc<pointer>;
+    using map_traits = std::allocator_traits<map_allocator>;
+
+    /// least amount of free map slots added on each side when the map is reallocated
+    static constexpr int map_buffer_ = 8;
+
+    /// chunk pointers
+    pointer* map_ = 0;
+    /// current amount of map slots
+    int map_allocated_ = 0;
+    /// free map slots before the first chunk
+    int map_left_ = 0;
+    /// free map slots after the last chunk
+    int map_right_ = 0;
+    /// position of the first element in the first chunk
+    int first_ = 0;
+    /// current amount of elements
+    int size_ = 0;
+    /// emptied chunk kept for the next push
+    pointer spare_ = 0;
+    Allocator allocator_;
+
+    /// amount of chunks in use
+    inline int _chunks() const {
+        return map_allocated_ - map_left_ - map_right_;
+    };
+    /// address of element at index, index is not checked
+    inline pointer _at(const int& index) const {
+        unsigned position = unsigned(first_ + index);
+        return map_[map_left_ + position / Chunk] + position % Chunk;
+    };
+
+    /// returns the spare chunk or a new one
+    pointer _take_chunk() {
+        if(spare_ == 0)
+            return alloc_traits::allocate(allocator_, Chunk);
+        pointer chunk = spare_;
+        spare_ = 0;
+        return chunk;
+    };
+    /// keeps an empty chunk as spare or frees it
+    void _give_chunk(pointer chunk) {
+        if(spare_ == 0)
+            spare_ = chunk;
+        else
+            alloc_traits::deallocate(allocator_, chunk, Chunk);
+    };
+
+    /// Moves chunk pointers to a map with free_left and free_right free slots
+    void _realloc_map(const int& free_left, const int& free_right) {
+        map_allocator allocator(allocator_);
+        int chunks = _chunks();
+        int new_alloc = free_left + chunks + free_right;
+        pointer* tmp = map_traits::allocate(allocator, new_alloc);
+        if(chunks > 0)
+            std::memcpy(tmp + free_left, map_ + map_left_, sizeof(pointer) * chunks);
+        if(map_ != 0)
+            map_traits::deallocate(allocator, map_, map_allocated_);
+
+        map_ = tmp;
+        map_allocated_ = new_alloc;
+        map_left_ = free_left;
+        map_right_ = free_right;
+    };
+    /// moves chunk pointers inside of the map so that new_left slots are free before them
+    void _shift_map(const int& new_left) {
+        std::memmove(map_ + new_left, map_ + map_left_, sizeof(pointer) * _chunks());
+        map_right_ += map_left_ - new_left;
+        map_left_ = new_left;
+    };
+    /// makes a free map slot after the last chunk
+    void _reserve_map_right() {
+        if(map_right_ > 0)
+            return;
+        int spare = _chunks() / 2 > map_buffer_ ? _chunks() / 2 : map_buffer_;
+        if(map_left_ > spare / 2)
+            // the left side has plenty of room, pointers are recentered instead
+            _shift_map(map_left_ / 2);
+        else
+            _realloc_map(map_left_ > map_buffer_ ? map_left_ : map_buffer_, spare);
+    };
+    /// makes a free map slot before the first chunk
+    void _reserve_map_left() {
+        if(map_left_ > 0)
+            return;
+        int spare = _chunks() / 2 > map_buffer_ ? _chunks() / 2 : map_buffer_;
+        if(map_right_ > spare / 2)
+            _shift_map(map_right_ - map_right_ / 2);
+        else
+            _realloc_map(spare, map_right_ > map_buffer_ ? map_right_ : map_buffer_);
+    };
+
+    /// Constructs an element after the last one.
+    /// A new chunk is linked only after the element is constructed in it
+    template<typename ...Arguments>
+    void _link_back(Arguments&&... args) {
+        int position = first_ + size_;
+        if(position < _chunks() * Chunk) {
+            alloc_traits::construct(allocator_, map_[map_left_ + position / Chunk] + position % Chunk,
+                                    std::forward<Arguments>(args)...);
+            ++size_;
+            return;
+        };
+
+        _reserve_map_right();
+        pointer chunk = _take_chunk();
+        try {
+            alloc_traits::construct(allocator_, chunk, std::forward<Arguments>(args)...);
+        } catch(...) {
+            _give_chunk(chunk);
+            throw;
+        };
+        map_[map_allocated_ - map_right_] = chunk;
+        --map_right_;
+        ++size_;
+    };
+    /// Constructs an element before the first one
+    template<typename ...Arguments>
+    void _link_front(Arguments&&... args) {
+        if(first_ > 0) {
+            alloc_traits::construct(allocator_, map_[map_left_] + first_ - 1, std::forward<Arguments>(args)...);
+            --first_;
+            ++size_;
+            return;
+        };
+
+        _reserve_map_left();
+        pointer chunk = _take_chunk();
+        try {
+            alloc_traits::construct(allocator_, chunk + Chunk - 1, std::forward<Arguments>(args)...);
+        } catch(...) {
+            _give_chunk(chunk);
+            throw;
+        };
+        --map_left_;
+        map_[map_left_] = chunk;
+        first_ = Chunk - 1;
+        ++size_;
+    };
+
+    /// destroys the last element, its chunk is released if it becomes empty
+    void _unlink_back() {
+        alloc_traits::destroy(allocator_, _at(size_ - 1));
+        --size_;
+        if(first_ + size_ == (_chunks() - 1) * Chunk) {
+            _give_chunk(map_[map_allocated_ - map_right_ - 1]);
+            ++map_right_;
+        };
+    };
+    /// destroys the first element, its chunk is released if it becomes empty
+    void _unlink_front() {
+        alloc_traits::destroy(allocator_, _at(0));
+        ++first_;
+        --size_;
+        if(first_ == Chunk) {
+            _give_chunk(map_[map_left_]);
+            ++map_left_;
+            first_ = 0;
+        };
+    };
+
+    /// frees all chunks and the map, elements must be destroyed before
+    void _free() {
+        for(int i = map_left_; i < map_allocated_ - map_right_; ++i)
+            alloc_traits::deallocate(allocator_, map_[i], Chunk);
+        if(spare_ != 0)
+            alloc_traits::deallocate(allocator_, spare_, Chunk);
+        if(map_ != 0) {
+            map_allocator allocator(allocator_);
+            map_traits::deallocate(allocator, map_, map_allocated_);
+        };
+        map_ = 0;
+        spare_ = 0;
+        map_allocated_ = map_left_ = map_right_ = first_ = size_ = 0;
+    };
+    /// destroys all elements
+    void _destroy() {
+        if constexpr(!std::is_trivially_destructible<T>::value)
+            for(int i = 0; i < size_; ++i)
+                alloc_traits::destroy(allocator_, _at(i));
+    };
+    /// takes chunks of other leaving it empty, this deque must hold no memory
+    void _take_storage(Deque& other) {
+        std::swap(map_, other.map_);
+        std::swap(map_allocated_, other.map_allocated_);
+        std::swap(map_left_, other.map_left_);
+        std::swap(map_right_, other.map_right_);
+        std::swap(first_, other.first_);
+        std::swap(size_, other.size_);
+        std::swap(spare_, other.spare_);
+    };
+
+    /// checks whether index is in range
+    inline void _check_except_index(const int& index) const {
+        if(index < 0 || index >= size_)
+            throw std::runtime_error("Deque exception: index out of range");
+    };
+    /// checks whether deque has elements
+    inline void _check_except_empty() const {
+        if(size_ == 0)
+            throw std::runtime_error("Deque exception: deque is empty");
+    };
+
+public:
+    Deque() {};
+    explicit Deque(const Allocator& allocator) : allocator_(allocator) {};
+    Deque(const int& size, const_reference default_value = T(), const Allocator& allocator = Allocator())
+        : allocator_(allocator) {
+        try {
+            for(int i = 0; i < size; ++i)
+                push_back(default_value);
+        } catch(...) {
+            _destroy();
+            _free();
+            throw;
+        };
+    };
+    Deque(const std::initializer_list<T>& list, const Allocator& allocator = Allocator())
+        : Deque(list.begin(), list.end(), allocator) {};
+    /// Range constructor, 'to' is not dereferenced!
+    template<typename InputIterator, typename = typename std::enable_if<!std::is_integral<InputIterator>::value>::type>
+    Deque(InputIterator from, const InputIterator& to, const Allocator& allocator = Allocator())
+        : allocator_(allocator) {
+        try {
+            for(; from != to; ++from)
+                push_back(*from);
+        } catch(...) {
+            _destroy();
+            _free();
+            throw;
+        };
+    };
+    Deque(const Deque& other)
+        : Deque(other.begin(), other.end(), alloc_traits::select_on_container_copy_construction(other.allocator_)) {};
+    Deque(Deque&& other) : allocator_(std::move(other.allocator_)) {
+        _take_storage(other);
+    };
+
+    Deque& operator=(const Deque& other) {
+        if(this != &other) {
+            clear();
+            for(const auto& element : other)
+                push_back(element);
+        };
+        return *this;
+    };
+    Deque& operator=(Deque&& other) {
+        if(this == &other)
+            return *this;
+        clear();
+        _free();
+        if constexpr(alloc_traits::propagate_on_container_move_assignment::value)
+            allocator_ = std::move(other.allocator_);
+        else if(allocator_ != other.allocator_) {
+            for(auto& element : other)
+                push_back(std::move(element));
+            other.clear();
+            return *this;
+        };
+        _take_storage(other);
+        return *this;
+    };
+
+    ~Deque() {
+        _destroy();
+        _free();
+    };
+
+    /// returns copy of the allocator
+    allocator_type get_allocator() const {
+        return allocator_;
+    };
+
+    /// returns current amount of elements
+    int size() const {
+        return size_;
+    };
+    bool empty() const {
+        return size_ == 0;
+    };
+    /// removes all elements, the map and one chunk are kept for reuse
+    void clear() {
+        while(size_ > 0)
+            _unlink_back();
+    };
+
+    void push_back(const_reference data) {
+        _link_back(data);
+    };
+    void push_back(value&& data) {
+        _link_back(std::move(data));
+    };
+    void push_front(const_reference data) {
+        _link_front(data);
+    };
+    void push_front(value&& data) {
+        _link_front(std::move(data));
+    };
+    /// constructs an element in place at the end
+    template<typename ...Arguments>
+    reference emplace_back(Arguments&&... args) {
+        _link_back(std::forward<Arguments>(args)...);
+        return back();
+    };
+    /// constructs an element in place at the beginning
+    template<typename ...Arguments>
+    reference emplace_front(Arguments&&... args) {
+        _link_front(std::forward<Arguments>(args)...);
+        return front();
+    };
+
+    /// removes last element returning it
+    value pop_back() {
+        _check_except_empty();
+        T result = std::move(*_at(size_ - 1));
+        _unlink_back();
+        return result;
+    };
+    /// removes first element returning it
+    value pop_front() {
+        _check_except_empty();
+        T result = std::move(*_at(0));
+        _unlink_front();
+        return result;
+    };
+
+    const_reference front() const {
+        _check_except_empty();
+        return *_at(0);
+    };
+    reference front() {
+        _check_except_empty();
+        return *_at(0);
+    };
+    const_reference back() const {
+        _check_except_empty();
+        return *_at(size_ - 1);
+    };
+    reference back() {
+        _check_except_empty();
+        return *_at(size_ - 1);
+    };
+
+    /// returns element at index in O(1)
+    reference get(const int& index) {
+        _check_except_index(index);
+        return *_at(index);
+    };
+    const_reference get(const int& index) const {
+        _check_except_index(index);
+        return *_at(index);
+    };
+    reference operator[](const int& index) {
+        return get(index);
+    };
+    const_reference operator[](const int& index) const {
+        return get(index);
+    };
+
+    iterator begin() {
+        return iterator(map_ + map_left_, first_);
+    };
+    const_iterator begin() const {
+        return cbegin();
+    };
+    const_iterator cbegin() const {
+        return const_iterator(map_ + map_left_, first_);
+    };
+    iterator end() {
+        return begin() + size_;
+    };
+    const_iterator end() const {
+        return cend();
+    };
+    const_iterator cend() const {
+        return cbegin() + size_;
+    };
+
+    /// Returns deque as text like " [ 0:a, 1:b ]".
+    /// Lines hold members_in_line elements (all in one line if it is <= 0),
+    /// show_indexes prefixes elements with their indexes, add_ws appends a line break
+    std::string to_string(const int& members_in_line = -1, bool show_indexes = false, bool add_ws = false) const {
+        std::string result;
+        {
+            format::Writer out(result);
+            format::write_range(out, begin(), size_, members_in_line, show_indexes);
+            if(add_ws)
+                out << '\n';
+        };
+        return result;
+    };
+    /// prints deque in [ ] brackets
+    void print() const {
+        std::cout << *this;
+    };
+    /// Outstream support example: std::cout.
+    /// Numbers use std::to_chars while out has default formatting, otherwise
+    /// (std::hex, setprecision, setw...) elements are passed to out one by one
+    friend std::ostream& operator<<(std::ostream& out, const Deque& deque) {
+        format::Writer writer(out);
+        format::write_range(writer, deque.begin(), deque.size());
+        writer << ' ';
+        return out;
+    };
+
+    bool operator==(const Deque& other) const {
+        if(size_ != other.size_)
+            return false;
+        auto iter = other.begin();
+        for(const auto& element : *this) {
+            if(!(element == *iter))
+                return false;
+            ++iter;
+        };
+        return true;
+    };
+    bool operator!=(const Deque& other) const {
+        return !(*this == other);
+    };
+};
+
+#endif // DEQUE_HPP
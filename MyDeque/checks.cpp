@@ -0,0 +1,105 @@
+#include "_deque.hpp"
+#include <vector>
+#include <string>
+#include <deque>
+#include <random>
+#include <algorithm>
+#include "../_checks.hpp"
+
+using namespace std;
+using namespace checks;
+
+// pushes and pops at both ends against std::deque, random access and iteration follow it
+static void check_ends() {
+    Deque<string, 8> deque;
+    std::deque<string> expected;
+    mt19937 random(25);
+    for(int i = 0; i < 50000; ++i) {
+        int op = int(random() % 4);
+        if(expected.empty() || op < 2) {
+            string value = to_string(i);
+            if(random() % 2) {
+                deque.push_back(value);
+                expected.push_back(value);
+            } else {
+                deque.push_front(value);
+                expected.push_front(value);
+            };
+        } else if(op == 2) {
+            check(deque.pop_back() == expected.back(), "pop_back returns the last element");
+            expected.pop_back();
+        } else {
+            check(deque.pop_front() == expected.front(), "pop_front returns the first element");
+            expected.pop_front();
+        };
+        check(deque.size() == int(expected.size()), "size follows pushes and pops");
+        if(!expected.empty())
+            check(deque.front() == expected.front() && deque.back() == expected.back(), "front and back");
+    };
+    check(equal(deque.begin(), deque.end(), expected.begin(), expected.end()), "iteration matches std::deque");
+    for(int i = 0; i < deque.size(); i += 97)
+        check(deque[i] == expected[i], "indexing matches std::deque");
+    check(deque.end() - deque.begin() == deque.size(), "distance between iterators");
+
+    deque.clear();
+    check(deque.empty() && deque.begin() == deque.end(), "clear empties the deque");
+    check(throws([&]() { deque.pop_back(); }), "pop of an empty deque throws");
+};
+
+// references to elements stay valid while elements are pushed and popped at both ends
+static void check_stable_references() {
+    Deque<int, 4> deque;
+    vector<int*> addresses;
+    for(int i = 0; i < 10; ++i) {
+        deque.push_back(i);
+        addresses.push_back(&deque.back());
+    };
+    int* first = &deque.front();
+    for(int i = 0; i < 10000; ++i) {
+        deque.push_back(-i);
+        deque.push_front(-i);
+    };
+    for(int i = 0; i < 5000; ++i) {
+        deque.pop_back();
+        deque.pop_front();
+    };
+    check(&deque[5000] == first, "front reference survives pushes at both ends");
+    bool stable = true;
+    for(int i = 0; i < 10; ++i)
+        stable = stable && &deque[5000 + i] == addresses[i] && *addresses[i] == i;
+    check(stable, "references survive growth of the chunk map");
+};
+
+// copies failing while chunks are being filled leave nothing behind
+static void check_exception_safety() {
+    vector<Counted> values(20);
+    for(int i = 0; i < 20; ++i)
+        values[i].value = i;
+    const int before = Counted::live;
+
+    Counted::throw_after = 9;
+    check(throws([&]() { Deque<Counted, 4> deque(12, values[0]); }), "fill constructor rethrows");
+    check(Counted::live == before, "fill constructor releases built elements");
+
+    Counted::throw_after = 13;
+    check(throws([&]() { Deque<Counted, 4> deque(values.begin(), values.end()); }), "range constructor rethrows");
+    check(Counted::live == before, "range constructor releases built elements");
+
+    Deque<Counted, 4> deque(values.begin(), values.begin() + 6);
+    const Counted* first = &deque[0];
+    Counted::throw_after = 0;
+    check(throws([&]() { deque.push_back(values[6]); }), "push_back rethrows");
+    Counted::throw_after = 0;
+    check(throws([&]() { deque.push_front(values[6]); }), "push_front rethrows");
+    check(deque.size() == 6 && deque[0].value == 0 && deque[5].value == 5, "failed pushes leave the deque unchanged");
+    check(&deque[0] == first, "failed pushes keep references valid");
+    check(Counted::live == before + 6, "failed copies are destroyed");
+};
+
+int main() {
+    return run([]() {
+        check_ends();
+        check_stable_references();
+        check_exception_safety();
+    });
+};
@@ -0,0 +1,123 @@
+#ifndef DEQUE_ITERATOR_HPP
+#define DEQUE_ITERATOR_HPP
+#include <iterator>
+#include <cstddef>
+#include <type_traits>
+
+/// Random access iterator for Deque.
+/// Keeps the slot of its chunk in the chunk map and the offset inside of the chunk,
+/// so moving between chunks does not touch the deque itself
+template<typename value, int Chunk>
+class DequeIterator {
+public:
+    using value_type = typename std::remove_const<value>::type;
+    using reference = value&;
+    using pointer = value*;
+    using iterator_category = std::random_access_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+
+private:
+    template<typename, int> friend class DequeIterator;
+
+    using chunk_pointer = value_type* const*;
+
+    chunk_pointer chunk_;
+    difference_type offset_;
+
+    /// moves by distance elements, offset_ stays in [0, Chunk)
+    void _advance(const difference_type& distance) {
+        difference_type position = offset_ + distance;
+        difference_type chunks = position >= 0 ? position / Chunk : -((Chunk - 1 - position) / Chunk);
+        chunk_ += chunks;
+        offset_ = position - chunks * Chunk;
+    };
+
+public:
+    DequeIterator() : chunk_(0), offset_(0) {};
+    DequeIterator(chunk_pointer chunk, const difference_type& offset) : chunk_(chunk), offset_(offset) {};
+    /// iterator converts to const iterator
+    template<typename other_value, typename = typename std::enable_if<
+                 std::is_same<const other_value, value>::value && !std::is_const<other_value>::value>::type>
+    DequeIterator(const DequeIterator<other_value, Chunk>& other) : chunk_(other.chunk_), offset_(other.offset_) {};
+
+    DequeIterator& operator++(){
+        if(++offset_ == Chunk) {
+            ++chunk_;
+            offset_ = 0;
+        };
+        return *this;
+    };
+    DequeIterator operator++(int){
+        DequeIterator copy = *this;
+        ++(*this);
+        return copy;
+    };
+    DequeIterator& operator--(){
+        if(offset_-- == 0) {
+            --chunk_;
+            offset_ = Chunk - 1;
+        };
+        return *this;
+    };
+    DequeIterator operator--(int){
+        DequeIterator copy = *this;
+        --(*this);
+        return copy;
+    };
+
+    DequeIterator& operator+=(const difference_type& distance){
+        _advance(distance);
+        return *this;
+    };
+    DequeIterator& operator-=(const difference_type& distance){
+        _advance(-distance);
+        return *this;
+    };
+    DequeIterator operator+(const difference_type& distance) const{
+        DequeIterator copy = *this;
+        copy._advance(distance);
+        return copy;
+    };
+    DequeIterator operator-(const difference_type& distance) const{
+        DequeIterator copy = *this;
+        copy._advance(-distance);
+        return copy;
+    };
+    friend DequeIterator operator+(const difference_type& distance, const DequeIterator& iter){
+        return iter + distance;
+    };
+    difference_type operator-(const DequeIterator& other) const{
+        return (chunk_ - other.chunk_) * Chunk + offset_ - other.offset_;
+    };
+
+    reference operator*() const{
+        return (*chunk_)[offset_];
+    };
+    pointer operator->() const{
+        return *chunk_ + offset_;
+    };
+    reference operator[](const difference_type& distance) const{
+        return *(*this + distance);
+    };
+
+    bool operator==(const DequeIterator& other) const {
+        return chunk_ == other.chunk_ && offset_ == other.offset_;
+    };
+    bool operator!=(const DequeIterator& other) const {
+        return !(*this == other);
+    };
+    bool operator<(const DequeIterator& other) const {
+        return *this - other < 0;
+    };
+    bool operator>(const DequeIterator& other) const {
+        return *this - other > 0;
+    };
+    bool operator<=(const DequeIterator& other) const {
+        return *this - other <= 0;
+    };
+    bool operator>=(const DequeIterator& other) const {
+        return *this - other >= 0;
+    };
+};
+
+#endif // DEQUE_ITERATOR_HPP
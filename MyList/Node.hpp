@@ -1,41 +1,46 @@
 #ifndef NODE_HPP
 #define NODE_HPP
+#include <new>
+#include <cstddef>
+#include <utility>
+#include <algorithm>
 
-/// Basic node for data structures
+/// Basic node for data structures.
+/// Value is stored inline so each element costs exactly one allocation
 template<typename value>
 struct Node {
-    /// the pointer may be replaced by value
-    value* data;
+    value data;
 
     Node* prev;
     Node* next;
 
     Node()
-        : data(new value()), prev(0), next(0) {};
+        : data(), prev(0), next(0) {};
+
+    /// constructs data in place from arguments
+    template<typename ...Arguments>
+    Node(std::in_place_t, Node* _prev, Node* _next, Arguments&&... args)
+        : data(std::forward<Arguments>(args)...), prev(_prev), next(_next) {};
 
     Node(const value* _data, Node* _prev, Node* _next)
-        : data(new value(*_data)), prev(_prev), next(_next) {};
+        : data(*_data), prev(_prev), next(_next) {};
 
     Node(const value& _data, Node* _prev, Node* _next)
         : Node(&_data, _prev, _next) {};
 
     Node(const Node* other)
-        : data(new value(*other->data)), prev(0), next(0) {};
+        : data(other->data), prev(0), next(0) {};
 
     Node(const Node& other) : Node(&other) {};
 
-    Node(Node&& other) : Node() {
-        using namespace std;
-
-        swap(data, other.data);
-        swap(next, other.next);
-        swap(prev, other.prev);
+    Node(Node&& other)
+        : data(std::move(other.data)), prev(other.prev), next(other.next) {
+        other.prev = other.next = 0;
     };
 
     const Node& operator=(const Node& other){
         if(this != &other) {
-            delete data;
-            data = new value(other.data);
+            data = other.data;
             next = other.next;
             prev = other.prev;
         };
@@ -51,9 +56,141 @@ struct Node {
 
         return *this;
     };
+};
+
+/// Node of unrolled list holding up to 'capacity' values in place.
+/// Values [0, count) are constructed, the rest of the storage is raw memory
+template<typename value, int capacity>
+struct UnrolledNode {
+    static_assert(capacity >= 2, "UnrolledNode must hold at least 2 values");
+
+    UnrolledNode* prev;
+    UnrolledNode* next;
+    int count;
+    alignas(value) unsigned char storage[sizeof(value) * capacity];
+
+    UnrolledNode(UnrolledNode* _prev, UnrolledNode* _next)
+        : prev(_prev), next(_next), count(0) {};
+
+    UnrolledNode(const UnrolledNode&) = delete;
+    const UnrolledNode& operator=(const UnrolledNode&) = delete;
+
+    value* data() {
+        return std::launder(reinterpret_cast<value*>(storage));
+    };
+    const value* data() const {
+        return std::launder(reinterpret_cast<const value*>(storage));
+    };
+
+    bool full() const {
+        return count == capacity;
+    };
+
+    /// constructs a value at position shifting the following ones right, node must not be full
+    template<typename ...Arguments>
+    void emplace(const int& position, Arguments&&... args) {
+        value* values = data();
+        if(position == count)
+            new(values + count) value(std::forward<Arguments>(args)...);
+        else {
+            value tmp(std::forward<Arguments>(args)...);
+            new(values + count) value(std::move(values[count - 1]));
+            std::move_backward(values + position, values + count - 1, values + count);
+            values[position] = std::move(tmp);
+        };
+        ++count;
+    };
+    /// destroys value at position shifting the following ones left
+    void erase(const int& position) {
+        value* values = data();
+        std::move(values + position + 1, values + count, values + position);
+        values[count - 1].~value();
+        --count;
+    };
 
-    ~Node(){
-        delete data;
+    /// moves values [from, count) to the end of 'other'
+    void move_back_to(UnrolledNode* other, const int& from) {
+        value* values = data();
+        value* destination = other->data() + other->count;
+        for(int i = from; i < count; ++i, ++destination) {
+            new(destination) value(std::move(values[i]));
+            values[i].~value();
+        };
+        other->count += count - from;
+        count = from;
+    };
+    /// moves first 'amount' values of 'other' to the end of this node
+    void steal_front(UnrolledNode* other, const int& amount) {
+        value* values = data() + count;
+        value* source = other->data();
+        for(int i = 0; i < amount; ++i)
+            new(values + i) value(std::move(source[i]));
+        std::move(source + amount, source + other->count, source);
+        for(int i = other->count - amount; i < other->count; ++i)
+            source[i].~value();
+        count += amount;
+        other->count -= amount;
+    };
+    /// moves last 'amount' values of 'other' to the front of this node
+    void steal_back(UnrolledNode* other, const int& amount) {
+        value* values = data();
+        // going from the end every slot is free before a value moves into it
+        for(int i = count - 1; i >= 0; --i) {
+            new(values + i + amount) value(std::move(values[i]));
+            values[i].~value();
+        };
+        value* source = other->data() + other->count - amount;
+        for(int i = 0; i < amount; ++i) {
+            new(values + i) value(std::move(source[i]));
+            source[i].~value();
+        };
+        count += amount;
+        other->count -= amount;
+    };
+
+    ~UnrolledNode() {
+        value* values = data();
+        for(int i = 0; i < count; ++i)
+            values[i].~value();
+    };
+};
+
+/// Node of indexable skip list.
+/// Level 0 is the usual double link, links of levels [1, height) are stored
+/// right after the node in the same allocation
+template<typename value>
+struct IndexedNode {
+    /// neighbours on one level and amount of level 0 steps to the next one
+    struct Link {
+        IndexedNode* next;
+        IndexedNode* prev;
+        int width;
+    };
+
+    value data;
+
+    IndexedNode* prev;
+    IndexedNode* next;
+    int height;
+
+    template<typename ...Arguments>
+    IndexedNode(const int& _height, Arguments&&... args)
+        : data(std::forward<Arguments>(args)...), prev(0), next(0), height(_height) {};
+
+    IndexedNode(const IndexedNode&) = delete;
+    const IndexedNode& operator=(const IndexedNode&) = delete;
+
+    /// bytes needed for a node with 'height' levels
+    static constexpr std::size_t bytes(const int& height) {
+        return sizeof(IndexedNode) + sizeof(Link) * (height - 1);
+    };
+
+    /// link of 'level' >= 1
+    Link& link(const int& level) {
+        return reinterpret_cast<Link*>(this + 1)[level - 1];
+    };
+    const Link& link(const int& level) const {
+        return reinterpret_cast<const Link*>(this + 1)[level - 1];
     };
 };
 
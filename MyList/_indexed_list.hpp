@@ -0,0 +1,723 @@
+#ifndef INDEXEDLIST_H
+#define INDEXEDLIST_H
+#include <new>
+#include <iostream>
+#include <stdexcept>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include "indexed_list_iterator.hpp"
+#include "node_pool.hpp"
+#include "chain_sort.hpp"
+
+/// Double-linked list with skip list levels on top of its nodes.
+/// Every link of an upper level knows how many nodes it spans,
+/// so positional access, insertion and removal take O(log n).
+/// A node of height h takes the room of several IndexedNode<T> of Allocator rebound to it,
+/// so with NodePool the nodes of height 1, three of four, come from its slabs
+template<typename T, typename Allocator = NodePool<T> >
+class IndexedList {
+private:
+    using Node = IndexedNode<T>;
+    using Link = typename Node::Link;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using reference = T&;
+    using const_reference = const T&;
+    using value = T;
+    using node_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+    using node_traits = std::allocator_traits<node_allocator>;
+
+public:
+    using iterator = IndexedListIterator<IndexedList, T, Node>;
+    using const_iterator = IndexedListIterator<IndexedList, const T, const Node>;
+
+    /// levels including level 0, enough for about 4^max_level elements
+    static constexpr int max_level = 16;
+    /// farthest index reached from the finger instead of descending from the top level
+    static constexpr int finger_reach = 32;
+
+private:
+    template<typename, typename, typename> friend class IndexedListIterator;
+
+    Node* _head = 0;
+    Node* _tail = 0;
+    int _size = 0;
+    /// upper links of the virtual node standing before the head, index 0 is level 1.
+    /// Node links pointing to it have null 'prev'
+    Link _header[max_level - 1];
+    /// xorshift state for node heights
+    unsigned int _seed = 2463534242u;
+    node_allocator _allocator;
+    /// Last accessed node and its index, indexed access near it walks from it.
+    /// Being changed by const methods it makes concurrent reads of one list unsafe
+    mutable Node* _finger = 0;
+    mutable int _finger_index = 0;
+
+    /// every level up has a quarter of nodes of the previous one
+    int _random_height() {
+        _seed ^= _seed << 13;
+        _seed ^= _seed >> 17;
+        _seed ^= _seed << 5;
+
+        int height = 1;
+        for(unsigned int bits = _seed; height < max_level && (bits & 3) == 0; bits >>= 2)
+            ++height;
+        return height;
+    };
+
+    /// amount of IndexedNode objects allocated for a node with 'height' levels
+    static constexpr std::size_t _units(const int& height) {
+        return (Node::bytes(height) + sizeof(Node) - 1) / sizeof(Node);
+    };
+    /// allocates a node constructing its data in place
+    template<typename ...Arguments>
+    Node* _create_node(const int& height, Arguments&&... args) {
+        Node* node = node_traits::allocate(_allocator, _units(height));
+        try {
+            node_traits::construct(_allocator, node, height, std::forward<Arguments>(args)...);
+        } catch(...) {
+            node_traits::deallocate(_allocator, node, _units(height));
+            throw;
+        };
+        return node;
+    };
+    /// destroys node's data and frees it
+    void _destroy_node(Node* node) {
+        const int height = node->height;
+        node_traits::destroy(_allocator, node);
+        node_traits::deallocate(_allocator, node, _units(height));
+    };
+
+    /// link of 'level' of node or of the header if node is null
+    Link& _link(Node* node, const int& level) {
+        return node != 0 ? node->link(level) : _header[level - 1];
+    };
+    const Link& _link(const Node* node, const int& level) const {
+        return node != 0 ? node->link(level) : _header[level - 1];
+    };
+
+    void _reset_header() {
+        for(auto& link : _header) {
+            link.next = link.prev = 0;
+            link.width = 1;
+        };
+    };
+
+    /// Finds the last node of every level standing before 'index' and its position.
+    /// Null node with position -1 means the header
+    void _find_before(const int& index, Node** update, int* positions) {
+        Node* tmp = 0;
+        int position = -1;
+        for(int level = max_level - 1; level >= 1; --level) {
+            Link* link = &_link(tmp, level);
+            while(link->next != 0 && position + link->width < index) {
+                position += link->width;
+                tmp = link->next;
+                link = &tmp->link(level);
+            };
+            update[level] = tmp;
+            positions[level] = position;
+        };
+    };
+    /// walks level 0 from 'node' standing at 'position' up to 'index'
+    static Node* _walk(Node* node, int position, const int& index) {
+        for(; position < index; ++position)
+            node = node->next;
+        return node;
+    };
+
+    /// also controls throwing exception
+    Node* _get_node(const int& index) const{
+        _check_except_index(index);
+
+        Node* tmp = 0;
+        if(_finger != 0 && std::abs(index - _finger_index) <= finger_reach)
+            tmp = index >= _finger_index ? _forward(_finger, index - _finger_index)
+                                         : _backward(_finger, _finger_index - index);
+        else
+            tmp = _find_node(index);
+
+        _finger = tmp;
+        _finger_index = index;
+        return tmp;
+    };
+    /// descends levels from the header to the node at 'index'
+    Node* _find_node(const int& index) const{
+        const Node* tmp = 0;
+        int position = -1;
+        for(int level = max_level - 1; level >= 1; --level) {
+            const Link* link = &_link(tmp, level);
+            while(link->next != 0 && position + link->width <= index) {
+                position += link->width;
+                tmp = link->next;
+                link = &tmp->link(level);
+            };
+        };
+        if(tmp == 0) {
+            tmp = _head;
+            position = 0;
+        };
+        return _walk(const_cast<Node*>(tmp), position, index);
+    };
+
+    template<typename ...Arguments>
+    Node* _emplace(const int& index, Arguments&&... args) {
+        _check_except_index_insert(index);
+
+        Node* update[max_level];
+        int positions[max_level];
+        _find_before(index, update, positions);
+
+        int height = _random_height();
+        Node* node = _create_node(height, std::forward<Arguments>(args)...);
+
+        // level 0
+        Node* prev = index == 0 ? 0 : update[1] != 0 ? _walk(update[1], positions[1], index - 1)
+                                                   : _walk(_head, 0, index - 1);
+        node->prev = prev;
+        node->next = prev != 0 ? prev->next : _head;
+        if(prev != 0)
+            prev->next = node;
+        else
+            _head = node;
+        if(node->next != 0)
+            node->next->prev = node;
+        else
+            _tail = node;
+
+        // upper levels
+        for(int level = 1; level < max_level; ++level) {
+            Link& before = _link(update[level], level);
+            if(level < height) {
+                Link& link = node->link(level);
+                link.next = before.next;
+                link.prev = update[level];
+                link.width = positions[level] + before.width + 1 - index;
+                if(link.next != 0)
+                    link.next->link(level).prev = node;
+                before.next = node;
+                before.width = index - positions[level];
+            } else
+                ++before.width;
+        };
+
+        ++_size;
+        if(_finger != 0 && index <= _finger_index)
+            ++_finger_index;
+        return node;
+    };
+
+    value _remove(const int& index) {
+        _check_except_index(index);
+
+        Node* update[max_level];
+        int positions[max_level];
+        _find_before(index, update, positions);
+        Node* node = update[1] != 0 ? _walk(update[1], positions[1], index) : _walk(_head, 0, index);
+
+        for(int level = 1; level < max_level; ++level) {
+            Link& before = _link(update[level], level);
+            if(before.next == node) {
+                Link& link = node->link(level);
+                before.next = link.next;
+                before.width += link.width - 1;
+                if(link.next != 0)
+                    link.next->link(level).prev = update[level];
+            } else
+                --before.width;
+        };
+
+        if(node->prev != 0)
+            node->prev->next = node->next;
+        else
+            _head = node->next;
+        if(node->next != 0)
+            node->next->prev = node->prev;
+        else
+            _tail = node->prev;
+
+        if(node == _finger)
+            _finger = 0;
+        else if(index < _finger_index)
+            --_finger_index;
+
+        value result = std::move(node->data);
+        _destroy_node(node);
+        --_size;
+        return result;
+    };
+
+    /// Node 'distance' steps after 'node', null is the end.
+    /// Takes the highest level that does not jump over the target
+    Node* _forward(const Node* node, std::ptrdiff_t distance) const {
+        while(distance > 0 && node != 0) {
+            int level = node->height - 1;
+            while(level >= 1 && node->link(level).width > distance)
+                --level;
+            if(level >= 1) {
+                distance -= node->link(level).width;
+                node = node->link(level).next;
+            } else {
+                node = node->next;
+                --distance;
+            };
+        };
+        if(distance != 0)
+            throw std::runtime_error("\nIndexedList iterator exception: advancing out of range");
+        return const_cast<Node*>(node);
+    };
+    /// node 'distance' steps before 'node', null 'node' is the end
+    Node* _backward(const Node* node, std::ptrdiff_t distance) const {
+        if(distance > 0 && node == 0) {
+            node = _tail;
+            --distance;
+        };
+        while(distance > 0 && node != 0) {
+            int level = node->height - 1;
+            while(level >= 1 && (node->link(level).prev == 0 ||
+                                 node->link(level).prev->link(level).width > distance))
+                --level;
+            if(level >= 1) {
+                node = node->link(level).prev;
+                distance -= node->link(level).width;
+            } else {
+                node = node->prev;
+                --distance;
+            };
+        };
+        if(distance != 0 || (node == 0 && _size != 0))
+            throw std::runtime_error("\nIndexedList iterator exception: advancing out of range");
+        return const_cast<Node*>(node);
+    };
+    /// index of node, size for the end
+    int _index_of(const Node* node) const {
+        int steps = 0;
+        while(node != 0) {
+            if(node->height > 1) {
+                steps += node->link(node->height - 1).width;
+                node = node->link(node->height - 1).next;
+            } else {
+                ++steps;
+                node = node->next;
+            };
+        };
+        return _size - steps;
+    };
+
+    /// links level 0 chain 'first'..'last' before 'position' (null means the end), levels need _relink()
+    void _link_chain(Node* position, Node* first, Node* last) {
+        Node* prev = position != 0 ? position->prev : _tail;
+        first->prev = prev;
+        last->next = position;
+        if(prev != 0)
+            prev->next = first;
+        else
+            _head = first;
+        if(position != 0)
+            position->prev = last;
+        else
+            _tail = last;
+    };
+    /// unlinks level 0 chain 'first'..'last' without destroying it, levels need _relink()
+    void _unlink_chain(Node* first, Node* last) {
+        if(first->prev != 0)
+            first->prev->next = last->next;
+        else
+            _head = last->next;
+        if(last->next != 0)
+            last->next->prev = first->prev;
+        else
+            _tail = first->prev;
+        first->prev = last->next = 0;
+    };
+    /// Rebuilds 'prev' links, the tail, the size and upper levels from 'next' links in O(n).
+    /// Nodes keep their heights, so the levels stay as balanced as they were
+    void _relink() {
+        _reset_header();
+        Node* last[max_level] = {};
+        int positions[max_level];
+        for(int level = 1; level < max_level; ++level)
+            positions[level] = -1;
+
+        Node* prev = 0;
+        int index = 0;
+        for(Node* tmp = _head; tmp != 0; prev = tmp, tmp = tmp->next, ++index) {
+            tmp->prev = prev;
+            for(int level = 1; level < tmp->height; ++level) {
+                Link& before = _link(last[level], level);
+                before.next = tmp;
+                before.width = index - positions[level];
+                Link& link = tmp->link(level);
+                link.next = 0;
+                link.prev = last[level];
+                last[level] = tmp;
+                positions[level] = index;
+            };
+        };
+        for(int level = 1; level < max_level; ++level)
+            _link(last[level], level).width = index - positions[level];
+
+        _tail = prev;
+        _size = index;
+        _finger = 0;
+    };
+
+    /// Makes nodes of 'other' freeable by this list's allocator.
+    /// False if allocators are incompatible and elements have to be moved one by one
+    bool _adopt_allocator(IndexedList& other) {
+        if(_allocator == other._allocator)
+            return true;
+        if constexpr(has_adopt<node_allocator>::value) {
+            _allocator.adopt(other._allocator);
+            return true;
+        };
+        return false;
+    };
+    /// exchanges nodes with 'other' keeping allocators
+    void _swap_nodes(IndexedList& other) {
+        std::swap(_head, other._head);
+        std::swap(_tail, other._tail);
+        std::swap(_size, other._size);
+        std::swap(_header, other._header);
+        std::swap(_seed, other._seed);
+        std::swap(_finger, other._finger);
+        std::swap(_finger_index, other._finger_index);
+    };
+
+    static Node* _node_of(const const_iterator& position) {
+        return const_cast<Node*>(position._node);
+    };
+
+    /// check index for exception
+    void _check_except_index(const int& index) const {
+        if(index < 0 || index >= _size)
+            throw std::runtime_error("IndexedList exception: index out of range");
+    };
+    void _check_except_index_insert(const int& index) const {
+        if(index < 0 || index > _size)
+            throw std::runtime_error("IndexedList exception: index out of range");
+    };
+
+public:
+    IndexedList() : _allocator() {
+        _reset_header();
+    };
+    explicit IndexedList(const Allocator& allocator) : _allocator(allocator) {
+        _reset_header();
+    };
+    IndexedList(const IndexedList& other)
+        : IndexedList(node_traits::select_on_container_copy_construction(other._allocator)) {
+        for(const auto& element : other)
+            push_back(element);
+    };
+    IndexedList(IndexedList&& other) : _allocator(std::move(other._allocator)) {
+        _reset_header();
+        _swap_nodes(other);
+    };
+    IndexedList(const std::initializer_list<T>& list) : IndexedList(list.begin(), list.end()) {};
+    /// Range constructor.
+    /// ForwardIterator must support dereferencing and prefix increment,
+    /// 'to' is not dereferenced!
+    template<typename ForwardIterator>
+    IndexedList(const ForwardIterator& from, const ForwardIterator& to) : IndexedList() {
+        for(auto iter = from; iter != to; ++iter)
+            push_back(*iter);
+    };
+
+    /// adds data to the end
+    void push_back(const_reference data){
+        _emplace(_size, data);
+    };
+    void push_back(value&& data){
+        _emplace(_size, std::move(data));
+    };
+    template<typename ...Arguments>
+    reference emplace_back(Arguments&&... args){
+        return _emplace(_size, std::forward<Arguments>(args)...)->data;
+    };
+
+    /// adds data to the beginning
+    void push_front(const_reference data){
+        _emplace(0, data);
+    };
+    void push_front(value&& data){
+        _emplace(0, std::move(data));
+    };
+    template<typename ...Arguments>
+    reference emplace_front(Arguments&&... args){
+        return _emplace(0, std::forward<Arguments>(args)...)->data;
+    };
+
+    /// inserts 'data' at 'index' in O(log n)
+    void insert(const_reference data, const int& index){
+        _emplace(index, data);
+    };
+    void insert(value&& data, const int& index){
+        _emplace(index, std::move(data));
+    };
+    template<typename ...Arguments>
+    reference emplace(const int& index, Arguments&&... args){
+        return _emplace(index, std::forward<Arguments>(args)...)->data;
+    };
+
+    /// removes data at 'index' in O(log n) returning its copy
+    value remove(const int& index){
+        return _remove(index);
+    };
+    /// removes the last element returning its copy
+    value pop_back(){
+        return _remove(_size - 1);
+    };
+    /// removes the first element returning its copy
+    value pop_front(){
+        return _remove(0);
+    };
+
+    /// returns reference to the element with the 'index' in O(log n)
+    reference get(const int& index){
+        return _get_node(index)->data;
+    };
+    const_reference get(const int& index) const{
+        return _get_node(index)->data;
+    };
+    /// sets the value at 'index' to 'data'
+    void set(const int& index, const_reference data){
+        get(index) = data;
+    };
+
+    reference front(){
+        return get(0);
+    };
+    const_reference front() const{
+        return get(0);
+    };
+    reference back(){
+        return get(_size - 1);
+    };
+    const_reference back() const{
+        return get(_size - 1);
+    };
+
+    reference operator[](const int& index) {
+        return get(index);
+    };
+    const_reference operator[](const int& index) const {
+        return get(index);
+    };
+
+    const int& size() const{
+        return _size;
+    };
+    /// true if the list is empty
+    bool empty() const{
+        return _size == 0;
+    };
+    void clear(){
+        while(_head != 0) {
+            Node* tmp = _head;
+            _head = _head->next;
+            _destroy_node(tmp);
+        };
+        _head = _tail = 0;
+        _size = 0;
+        _finger = 0;
+        _reset_header();
+    };
+    /// prints the list in []-brackets
+    void print() const {
+        std::cout << *this;
+    };
+
+    void swap(IndexedList& other) {
+        _swap_nodes(other);
+        std::swap(_allocator, other._allocator);
+    };
+
+    /// Moves all elements of 'other' before 'position' by relinking nodes.
+    /// Levels of both lists are rebuilt in O(n + m), elements are moved one by one
+    /// only if allocators are different and can not be merged
+    void splice(const const_iterator& position, IndexedList&& other) {
+        if(this == &other || other._size == 0)
+            return;
+
+        Node* at = _node_of(position);
+        if(!_adopt_allocator(other)) {
+            int index = _index_of(at);
+            for(auto& element : other)
+                _emplace(index++, std::move(element));
+            other.clear();
+            return;
+        };
+
+        _link_chain(at, other._head, other._tail);
+        other._head = other._tail = 0;
+        other._relink();
+        _relink();
+    };
+    void splice(const const_iterator& position, IndexedList& other) {
+        splice(position, std::move(other));
+    };
+    /// Moves range 'first'->'last' excluding 'last' of 'other' before 'position' by relinking nodes.
+    /// Levels of both lists are rebuilt in O(n + m).
+    /// 'position' must not be inside of the range
+    void splice(const const_iterator& position, IndexedList& other,
+                const const_iterator& first, const const_iterator& last) {
+        Node* from = _node_of(first);
+        Node* to = _node_of(last);
+        if(from == to)
+            return;
+
+        Node* at = _node_of(position);
+        if(this != &other && !_adopt_allocator(other)) {
+            int index = _index_of(at);
+            int removed = other._index_of(from);
+            int count = other._index_of(to) - removed;
+            for(Node* tmp = from; tmp != to; tmp = tmp->next)
+                _emplace(index++, std::move(tmp->data));
+            for(; count > 0; --count)
+                other._remove(removed);
+            return;
+        };
+
+        Node* back = to != 0 ? to->prev : other._tail;
+        other._unlink_chain(from, back);
+        if(this != &other)
+            other._relink();
+        _link_chain(at, from, back);
+        _relink();
+    };
+    void splice(const const_iterator& position, IndexedList&& other,
+                const const_iterator& first, const const_iterator& last) {
+        splice(position, other, first, last);
+    };
+
+    /// Stable merge sort relinking nodes in O(n log n), levels are rebuilt afterwards in O(n).
+    /// Elements are never copied or moved
+    template<typename Compare>
+    void sort(Compare compare) {
+        if(_size < 2)
+            return;
+        _head = sort_chain(_head, compare);
+        _relink();
+    };
+    void sort() {
+        sort(std::less<T>());
+    };
+
+    /// Merges sorted 'other' into this sorted list by relinking nodes, 'other' becomes empty.
+    /// Equal elements of this list go first
+    template<typename Compare>
+    void merge(IndexedList&& other, Compare compare) {
+        if(this == &other || other._size == 0)
+            return;
+
+        Node* last = _tail;
+        splice(cend(), std::move(other));
+        if(last == 0)
+            return;
+
+        Node* second = last->next;
+        last->next = 0;
+        _head = merge_chains(_head, second, compare);
+        _relink();
+    };
+    void merge(IndexedList&& other) {
+        merge(std::move(other), std::less<T>());
+    };
+    template<typename Compare>
+    void merge(IndexedList& other, Compare compare) {
+        merge(std::move(other), compare);
+    };
+    void merge(IndexedList& other) {
+        merge(std::move(other), std::less<T>());
+    };
+
+    bool operator==(const IndexedList& list) const{
+        if(_size != list._size)
+            return false;
+        const Node* tmp1 = _head;
+        const Node* tmp2 = list._head;
+        for(; tmp1 != 0; tmp1 = tmp1->next, tmp2 = tmp2->next)
+            if(tmp1->data != tmp2->data)
+                return false;
+        return true;
+    };
+    bool operator!=(const IndexedList& list) const{
+        return !(*this == list);
+    };
+
+    const IndexedList& operator=(const IndexedList& other){
+        if(this != &other){
+            clear();
+            for(const auto& element : other)
+                push_back(element);
+        };
+        return *this;
+    };
+    const IndexedList& operator=(IndexedList&& other){
+        if(this != &other){
+            clear();
+            if constexpr(node_traits::propagate_on_container_move_assignment::value)
+                _allocator = std::move(other._allocator);
+            else if(_allocator != other._allocator) {
+                for(auto& element : other)
+                    push_back(std::move(element));
+                other.clear();
+                return *this;
+            };
+            _swap_nodes(other);
+        };
+        return *this;
+    };
+
+    /// list supports using output streams with it like std::cout<<
+    friend std::ostream& operator<<(std::ostream& out, const IndexedList& list){
+        out << " [ ";
+        if(list.size() > 0) {
+            auto iter = list.begin();
+            for(int i = 0; i < list.size() - 1; ++i, ++iter)
+                out << *iter << ", ";
+            out << *iter << ' ';
+        };
+        out << "] ";
+        return out;
+    };
+
+    iterator begin(){
+        return iterator(this, _head);
+    };
+    const_iterator begin() const{
+        return cbegin();
+    };
+    const_iterator cbegin() const{
+        return const_iterator(this, _head);
+    };
+
+    /// returns iterator at position in O(log n)
+    iterator at(const int& index){
+        return iterator(this, _get_node(index));
+    };
+    const_iterator at(const int& index) const{
+        return cat(index);
+    };
+    const_iterator cat(const int& index) const{
+        return const_iterator(this, _get_node(index));
+    };
+
+    iterator end(){
+        return iterator(this, 0);
+    };
+    const_iterator end() const{
+        return cend();
+    };
+    const_iterator cend() const{
+        return const_iterator(this, 0);
+    };
+
+    ~IndexedList(){
+        clear();
+    };
+};
+
+#endif // INDEXEDLIST_H
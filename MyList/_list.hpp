@@ -1,36 +1,85 @@
 #ifndef LINKEDLIST_H
 #define LINKEDLIST_H
 #include <iostream>
+#include <cstdlib>
 #include <algorithm>
+#include <functional>
+#include <thread>
+#include <vector>
+#include <limits>
 #include "list_iterator.hpp"
-
-/// Double-linked list implementation
-template<typename T> class List{
+#include "list_view.hpp"
+#include "node_pool.hpp"
+#include "chain_sort.hpp"
+#include "../_binary.hpp"
+#include "../_format.hpp"
+
+/// true if Iterator can be passed over twice, so a range can be counted before it is copied
+template<typename Iterator, typename = void>
+struct is_forward_iterator : std::false_type {};
+template<typename Iterator>
+struct is_forward_iterator<Iterator, std::void_t<typename std::iterator_traits<Iterator>::iterator_category> >
+        : std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<Iterator>::iterator_category> {};
+
+/// Double-linked list implementation.
+/// Nodes are allocated through Allocator rebound to Node<T>,
+/// by default they come from a slab pool owned by the list
+template<typename T, typename Allocator = NodePool<T> > class List{
 private:
     /// a function that sets element's value by its index
     using InitializerFunction = T (*)(const int& index);
-    /// rai iterator
+    /// least amount of elements sorted by one thread of parallel_sort
+    static constexpr int parallel_sort_run = 1 << 14;
+    /// bidirectional iterator
     using iterator = ListIterator<T>;
-    /// read-only rai iterator
-    using const_iterator = ConstListIterator<T>;;
+    /// read-only bidirectional iterator
+    using const_iterator = ConstListIterator<T>;
+    /// random access snapshot of node positions
+    using view = ListView<T>;
+    using const_view = ListView<const T>;
 
-    using Node = Node<T>;
+    using Node = ::Node<T>;
     using pointer = T*;
     using const_pointer = const T*;
     using reference = T&;
     using const_reference = const T&;
     using value = T;
+    using node_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+    using node_traits = std::allocator_traits<node_allocator>;
 
     Node* _head = 0;
     Node* _tail = 0;
     int _size = 0;
+    node_allocator _allocator;
+    /// Last accessed node and its index, indexed access starts from it when it is closer.
+    /// Being changed by const methods it makes concurrent reads of one list unsafe
+    mutable Node* _finger = 0;
+    mutable int _finger_index = 0;
 
     /// also controls throwing exception
     Node* _get_node(const int& index) const{
         _check_except_index(index);
-        if(index > _size / 2)
-            return _from__tail(index);
-        return _from__head(index);
+
+        int distance = index < _size - 1 - index ? index : _size - 1 - index;
+        Node* tmp = 0;
+        if(_finger != 0 && std::abs(index - _finger_index) < distance)
+            tmp = _from__finger(index);
+        else if(index > _size / 2)
+            tmp = _from__tail(index);
+        else
+            tmp = _from__head(index);
+
+        _finger = tmp;
+        _finger_index = index;
+        return tmp;
+    };
+    Node* _from__finger(const int& index) const{
+        Node* tmp = _finger;
+        for(int i = _finger_index; i < index; ++i)
+            tmp = tmp->next;
+        for(int i = _finger_index; i > index; --i)
+            tmp = tmp->prev;
+        return tmp;
     };
     Node* _from__head(const int& index) const{
         Node* tmp = _head;
@@ -46,70 +95,234 @@ private:
     };
 
     reference _get_data(const int& index){
-        return *(_get_node(index)->data);
+        return _get_node(index)->data;
     };
-    value _get_data(const int& index) const{
-        return *(_get_node(index)->data);
+    const_reference _get_data(const int& index) const{
+        return _get_node(index)->data;
     };
 
-    /// concates a tmp list by pointer exchange
-    void _concate_to_copy(List&& list) {
-        if(_size == 0) {
-            *this = List(list);
+    /// allocates a node constructing its data in place
+    template<typename ...Arguments>
+    Node* _create_node(Node* prev, Node* next, Arguments&&... args) {
+        Node* node = node_traits::allocate(_allocator, 1);
+        try {
+            node_traits::construct(_allocator, node, std::in_place, prev, next, std::forward<Arguments>(args)...);
+        } catch(...) {
+            node_traits::deallocate(_allocator, node, 1);
+            throw;
+        };
+        return node;
+    };
+    /// Builds a chain of 'count' nodes and links it to the end at once.
+    /// construct(node, prev) must construct a node in place after 'prev'.
+    /// A pooled allocator gives one contiguous block for the whole chain
+    template<typename Construct>
+    void _append_chain(const int& count, Construct construct) {
+        if(count <= 0)
             return;
+        Node* block = 0;
+        if constexpr(has_allocate_bulk<node_allocator>::value)
+            block = _allocator.allocate_bulk(count);
+
+        Node* first = 0;
+        Node* last = 0;
+        int built = 0;
+        try {
+            for(; built < count; ++built) {
+                Node* node = block != 0 ? block + built : node_traits::allocate(_allocator, 1);
+                try {
+                    construct(node, last);
+                } catch(...) {
+                    if(block == 0)
+                        node_traits::deallocate(_allocator, node, 1);
+                    throw;
+                };
+                if(last != 0)
+                    last->next = node;
+                else
+                    first = node;
+                last = node;
+            };
+        } catch(...) {
+            while(first != 0) {
+                Node* next = first->next;
+                _destroy_node(first);
+                first = next;
+            };
+            if(block != 0)
+                for(; built < count; ++built)
+                    node_traits::deallocate(_allocator, block + built, 1);
+            throw;
         };
 
-        _tail->next = list._head;
-        _tail->next->prev = _tail;
-        _tail = list._tail;
-        _size += list.size();
+        _link_chain(0, first, last, count);
+    };
+    /// constructs node's data in place from the arguments
+    template<typename ...Arguments>
+    void _construct_node(Node* node, Node* prev, Arguments&&... args) {
+        node_traits::construct(_allocator, node, std::in_place, prev, static_cast<Node*>(0),
+                               std::forward<Arguments>(args)...);
+    };
+    /// appends copies of 'count' values stored one after another
+    void _append_values(const_pointer data, const int& count) {
+        _append_chain(count, [&](Node* node, Node* prev) {
+            _construct_node(node, prev, *data);
+            ++data;
+        });
+    };
+    /// Appends a range, ranges that can be passed twice are counted first to be built at once
+    template<typename ForwardIterator>
+    void _append_range(const ForwardIterator& from, const ForwardIterator& to) {
+        auto iter = from;
+        if constexpr(is_forward_iterator<ForwardIterator>::value) {
+            _append_chain(int(std::distance(from, to)), [&](Node* node, Node* prev) {
+                _construct_node(node, prev, *iter);
+                ++iter;
+            });
+        } else
+            while(iter != to){
+                push_back(*iter);
+                ++iter;
+            };
+    };
+    /// destroys node's data and frees it
+    void _destroy_node(Node* node) {
+        node_traits::destroy(_allocator, node);
+        node_traits::deallocate(_allocator, node, 1);
+    };
+
+    /// links a new node to the tail
+    template<typename ...Arguments>
+    void _link_back(Arguments&&... args) {
+        Node* tmp = _create_node(_tail, 0, std::forward<Arguments>(args)...);
+        if(_size == 0)
+            _head = tmp;
+        else
+            _tail->next = tmp;
+        _tail = tmp;
+        ++_size;
+    };
+    /// links a new node to the head
+    template<typename ...Arguments>
+    void _link_front(Arguments&&... args) {
+        Node* tmp = _create_node(0, _head, std::forward<Arguments>(args)...);
+        if(_size == 0)
+            _tail = tmp;
+        else
+            _head->prev = tmp;
+        _head = tmp;
+        ++_size;
+        ++_finger_index;
+    };
+
+    /// unlinks and destroys the last node
+    void _unlink_back() {
+        Node* tmp = _tail;
+        _tail = _tail->prev;
+        if(_tail != 0)
+            _tail->next = 0;
+        else
+            _head = 0;
+        if(_finger == tmp)
+            _finger = 0;
+        _destroy_node(tmp);
+        --_size;
+    };
+    /// unlinks and destroys the first node
+    void _unlink_front() {
+        Node* tmp = _head;
+        _head = _head->next;
+        if(_head != 0)
+            _head->prev = 0;
+        else
+            _tail = 0;
+        if(_finger == tmp)
+            _finger = 0;
+        --_finger_index;
+        _destroy_node(tmp);
+        --_size;
+    };
+
+    /// Makes nodes of 'other' freeable by this list's allocator.
+    /// False if allocators are incompatible and elements have to be moved one by one
+    bool _adopt_allocator(List& other) {
+        if(_allocator == other._allocator)
+            return true;
+        if constexpr(has_adopt<node_allocator>::value) {
+            _allocator.adopt(other._allocator);
+            return true;
+        };
+        return false;
+    };
 
-        list._tail = list._head = 0;
-        list._size = 0;
+    /// concates a tmp list by pointer exchange
+    void _concate_to_copy(List&& list) {
+        splice(cend(), std::move(list));
     };
 
     /// inserts a tmp list by pointer exchange
     void _insert_to_copy(List&& list, const int& index) {
         _check_except_index_insert(index);
-
-        if(_size == 0) {
-            // exchange lists
-            *this = list;
+        splice(index == _size ? cend() : cat(index), std::move(list));
+    };
+
+    static Node* _node_of(const const_iterator& position) {
+        return position._iter._node;
+    };
+
+    /// links chain 'first'..'last' of 'count' nodes before 'position' (null means the end)
+    void _link_chain(Node* position, Node* first, Node* last, const int& count) {
+        Node* prev = position != 0 ? position->prev : _tail;
+        first->prev = prev;
+        last->next = position;
+        if(prev != 0)
+            prev->next = first;
+        else
+            _head = first;
+        if(position != 0)
+            position->prev = last;
+        else
+            _tail = last;
+        _size += count;
+
+        // finger stays valid only if the chain is surely linked after it
+        if(position == 0 && count != 0)
             return;
+        if(prev == 0 || position == _finger)
+            _finger_index += count;
+        else
+            _finger = 0;
+    };
+    /// unlinks chain 'first'..'last' of 'count' nodes without destroying it
+    void _unlink_chain(Node* first, Node* last, const int& count) {
+        if(first->prev != 0)
+            first->prev->next = last->next;
+        else
+            _head = last->next;
+        if(last->next != 0)
+            last->next->prev = first->prev;
+        else
+            _tail = first->prev;
+        first->prev = last->next = 0;
+        _size -= count;
+        _finger = 0;
+    };
+    /// constructs a new node before 'position'
+    template<typename ...Arguments>
+    void _emplace_before(Node* position, Arguments&&... args) {
+        Node* node = _create_node(0, 0, std::forward<Arguments>(args)...);
+        _link_chain(position, node, node, 1);
+    };
+
+    /// restores 'prev' links and the tail after relinking by 'next' only
+    void _relink() {
+        Node* prev = 0;
+        for(Node* tmp = _head; tmp != 0; tmp = tmp->next) {
+            tmp->prev = prev;
+            prev = tmp;
         };
-        if(index == _size) {
-            _concate_to_copy(std::move(list));
-            return;
-        };
-
-
-        Node* at = _get_node(index);
-
-        if(at->prev == 0) {
-            // inserting to the _head
-            at->prev = list._tail;
-            at->prev->next = _head;
-            _head = list._head;
-        } else if(at == 0) {
-            // inserting to the tail
-            _tail->next = list._head;
-            _tail->next->prev = _tail;
-            _tail = list._tail;
-        } else {
-            // inserting in between
-            Node* prev = at->prev;
-            prev->next = list._head;
-            prev->next->prev = prev;
-            at->prev = list._tail;
-            at->prev->next = at;
-            prev = 0;
-        };
-
-        _size += list.size();
-
-        at = 0;
-        list._head = list._tail = 0;
-        list._size = 0;
+        _tail = prev;
+        _finger = 0;
     };
 
     /// check index for exception
@@ -128,38 +341,45 @@ private:
     };
 
 public:
-    List() : _size(0), _head(0), _tail(0) {};
-    List(const List* other) : List() {
-        Node* tmp = other->_head;
-        while(tmp != 0){
-            push_back(tmp->data);
+    List() : _head(0), _tail(0), _size(0), _allocator() {};
+    explicit List(const Allocator& allocator) : _head(0), _tail(0), _size(0), _allocator(allocator) {};
+    List(const List* other)
+        : List(node_traits::select_on_container_copy_construction(other->_allocator)) {
+        const Node* tmp = other->_head;
+        _append_chain(other->_size, [&](Node* node, Node* prev) {
+            _construct_node(node, prev, tmp->data);
             tmp = tmp->next;
-        };
+        });
     };
     List(const List& other) : List(&other) {};
-    List(List&& other) {
+    List(List&& other) : _allocator(std::move(other._allocator)) {
         std::swap(_head, other._head);
         std::swap(_tail, other._tail);
         std::swap(_size, other._size);
+        std::swap(_finger, other._finger);
+        std::swap(_finger_index, other._finger_index);
     };
 
     List(const_pointer data, const int& count, const int& from = 0) : List() {
         _check_except_size(count);
         if(data != 0)
-            for(int i = from; i < count + from; ++i)
-                push_back(data + from + i);
+            _append_values(data + from, count);
     };
     List(const int& size, const_reference default_member = T()) : List() {
         _check_except_size(size);
-        for(int i = 0; i < size; ++i)
-            push_back(&default_member);
+        _append_chain(size, [&](Node* node, Node* prev) {
+            _construct_node(node, prev, default_member);
+        });
     };
     List(const int& size, const_pointer default_member) : List(size, *default_member) {};
 
     List(const int& size, InitializerFunction func) : List() {
         _check_except_size(size);
-        for(int i = 0; i < size; ++i)
-            push_back(func(i));
+        int index = 0;
+        _append_chain(size, [&](Node* node, Node* prev) {
+            _construct_node(node, prev, func(index));
+            ++index;
+        });
     };
     List(const std::initializer_list<T>& list) : List(list.begin(), list.end()) {};
     /// Range constructor.
@@ -167,11 +387,7 @@ public:
     /// 'to' is not dereferenced!
     template<typename ForwardIterator>
     List(const ForwardIterator& from, const ForwardIterator& to) : List() {
-        auto iter = from;
-        while(iter != to){
-            push_back(*iter);
-            ++iter;
-        };
+        _append_range(from, to);
     };
     /// Two range constructor.
     /// ForwardIterator1 & ForwardIterator2 must support dereferencing and prefix increment,
@@ -179,46 +395,44 @@ public:
     template<typename ForwardIterator1, typename ForwardIterator2 = ForwardIterator1>
     List(const ForwardIterator1& from1, const ForwardIterator1& to1,
          const ForwardIterator2& from2, const ForwardIterator2& to2) : List(from1, to1) {
-        auto iter = from2;
-        while(iter != to2){
-            push_back(*iter);
-            ++iter;
-        };
+        _append_range(from2, to2);
     };
 
     /// adds data to the list in the defined order
     void push_front(const_pointer data, const int& count = 1){
         _check_except_size(count);
-        for(int i = 0; i < count; ++i){
-            Node* tmp = new Node(data + i, 0, _head);
-            if(_size == 0)
-                _tail = tmp;
-            else
-                _head->prev = tmp;
-            _head = tmp;
-            ++_size;
-        };
+        for(int i = 0; i < count; ++i)
+            _link_front(data[i]);
     };
     void push_front(const_reference data){
-        push_front(&data);
+        _link_front(data);
+    };
+    void push_front(value&& data){
+        _link_front(std::move(data));
+    };
+    /// constructs an element in place at the beginning
+    template<typename ...Arguments>
+    reference emplace_front(Arguments&&... args){
+        _link_front(std::forward<Arguments>(args)...);
+        return _head->data;
     };
 
     /// adds data to the list in the defined order
     void push_back(const_pointer data, const int& count = 1){
         _check_except_size(count);
-
-        for(int i = 0; i < count; ++i){
-            Node* tmp = new Node(data + i, _tail, 0);
-            if(_size == 0)
-                _head = tmp;
-            else
-                _tail->next = tmp;
-            _tail = tmp;
-            ++_size;
-        };
+        _append_values(data, count);
     };
     void push_back(const_reference data){
-        push_back(&data);
+        _link_back(data);
+    };
+    void push_back(value&& data){
+        _link_back(std::move(data));
+    };
+    /// constructs an element in place at the end
+    template<typename ...Arguments>
+    reference emplace_back(Arguments&&... args){
+        _link_back(std::forward<Arguments>(args)...);
+        return _tail->data;
     };
 
     /// returns reference to the first element
@@ -247,8 +461,7 @@ public:
 
     /// sets the value at 'index' to 'data'
     void set(const int& index, const_pointer data){
-        _check_except_index(index);
-        memcpy(_get_node(index)->data, data, sizeof(T));
+        _get_node(index)->data = *data;
     };
     void set(const int& index, const_reference data){
         set(index, &data);
@@ -270,35 +483,52 @@ public:
             return false;
         return true;
     };
+    /// Destroys every element.
+    /// A pooled allocator frees its slabs at once instead of node by node if no other
+    /// list keeps nodes in it, pools merged by splice() are shared but may hold only ours
     void clear(){
-        if(_size > 0)
-            pop_back(_size);
+        if constexpr(has_release<node_allocator>::value)
+            if(_allocator.unique() || _allocator.live() == std::size_t(_size)) {
+                if constexpr(!std::is_trivially_destructible<T>::value)
+                    for(Node* tmp = _head; tmp != 0; tmp = tmp->next)
+                        node_traits::destroy(_allocator, tmp);
+                _allocator.release();
+                _head = _tail = 0;
+                _size = 0;
+                _finger = 0;
+                return;
+            };
+
+        while(_head != 0) {
+            Node* tmp = _head;
+            _head = _head->next;
+            _destroy_node(tmp);
+        };
         _head = _tail = 0;
         _size = 0;
+        _finger = 0;
     };
     /// prints the list in []-brackets
     void print() const {
         std::cout << *this;
     };
+#ifdef FORMAT_FD
+    /// Writes list as to_string() does straight to a file descriptor, e.g. of a dump file
+    void print(const int& fd, const int& members_in_line = -1, bool show_indexes = false) const {
+        format::Writer out(fd);
+        format::write_range(out, begin(), _size, members_in_line, show_indexes);
+        out << '\n';
+    };
+#endif
 
     /// removes the last element returning its copy
     value pop_back(const int& count = 1){
         _check_except_index(count - 1);
-        value result;
-
-        for(int i = 0; i < count; ++i){
-            if(i == count - 1)
-                result = T(back());
-            if(_size > 1){
-                _tail->prev->next = 0;
-                free(_tail->data);
-                _tail = _tail->prev;
-            } else {
-                free(_tail);
-                _head = _tail = 0;
-            };
-            --_size;
-        };
+
+        for(int i = 1; i < count; ++i)
+            _unlink_back();
+        value result = std::move(_tail->data);
+        _unlink_back();
 
         return result;
     };
@@ -306,21 +536,11 @@ public:
     /// removes the first element returning its copy
     value pop_front(const int& count = 1){
         _check_except_index(count - 1);
-        value result;
-
-        for(int i = 0; i < count; ++i){
-            if(i == count - 1)
-                result = T(back());
-            if(_size > 1){
-                _head->next->prev = 0;
-                free(_head->data);
-                _head = _head->next;
-            } else {
-                free(_head);
-                _head = _tail = 0;
-            };
-            --_size;
-        };
+
+        for(int i = 1; i < count; ++i)
+            _unlink_front();
+        value result = std::move(_head->data);
+        _unlink_front();
 
         return result;
     };
@@ -334,11 +554,12 @@ public:
         else if(index == _size)
             push_back(data);
         else if(index < _size){
-            Node* new_node = new Node(data, 0, _get_node(index));
+            Node* new_node = _create_node(0, _get_node(index), *data);
             new_node->prev = new_node->next->prev;
             new_node->next->prev->next = new_node;
             new_node->next->prev = new_node;
             ++_size;
+            _finger = new_node;
         };
     };
     void insert(const_reference data, const int& index){
@@ -371,10 +592,11 @@ public:
             return pop_back();
         else{
             Node* tmp = _get_node(index);
-            value result = *tmp->data;
+            value result = std::move(tmp->data);
             tmp->next->prev = tmp->prev;
             tmp->prev->next = tmp->next;
-            delete tmp;
+            _finger = tmp->next;
+            _destroy_node(tmp);
             --_size;
 
             return result;
@@ -402,6 +624,71 @@ public:
         return flag;
     };
 
+    /// Moves all elements of 'other' before 'position' by relinking nodes in O(1).
+    /// Pools of both lists are merged, elements are moved one by one only
+    /// if allocators are different and can not be merged
+    void splice(const const_iterator& position, List&& other) {
+        if(this == &other || other._size == 0)
+            return;
+
+        Node* at = _node_of(position);
+        if(!_adopt_allocator(other)) {
+            for(auto& element : other)
+                _emplace_before(at, std::move(element));
+            other.clear();
+            return;
+        };
+
+        _link_chain(at, other._head, other._tail, other._size);
+        other._head = other._tail = 0;
+        other._size = 0;
+        other._finger = 0;
+    };
+    void splice(const const_iterator& position, List& other) {
+        splice(position, std::move(other));
+    };
+    /// Moves range 'first'->'last' excluding 'last' of 'other' before 'position' by relinking nodes.
+    /// Takes time linear in range length only to count moved elements.
+    /// 'position' must not be inside of the range
+    void splice(const const_iterator& position, List& other,
+                const const_iterator& first, const const_iterator& last) {
+        Node* from = _node_of(first);
+        Node* to = _node_of(last);
+        if(from == to)
+            return;
+
+        Node* back = to != 0 ? to->prev : other._tail;
+        Node* at = _node_of(position);
+        if(this == &other) {
+            _unlink_chain(from, back, 0);
+            _link_chain(at, from, back, 0);
+            return;
+        };
+
+        int count = 1;
+        for(Node* tmp = from; tmp != back; tmp = tmp->next)
+            ++count;
+
+        if(!_adopt_allocator(other)) {
+            for(Node* tmp = from; tmp != to; tmp = tmp->next)
+                _emplace_before(at, std::move(tmp->data));
+            while(from != to) {
+                Node* next = from->next;
+                other._unlink_chain(from, from, 1);
+                other._destroy_node(from);
+                from = next;
+            };
+            return;
+        };
+
+        other._unlink_chain(from, back, count);
+        _link_chain(at, from, back, count);
+    };
+    void splice(const const_iterator& position, List&& other,
+                const const_iterator& first, const const_iterator& last) {
+        splice(position, other, first, last);
+    };
+
     /// returns a sublist from defined range excluding 'to'
     List sublist(const int& from, const int& to) const{
         _check_except_index(from);
@@ -426,7 +713,7 @@ public:
         concate(&other);
     };
     void concate(List&& other){
-        concate(std::move(other));
+        splice(cend(), std::move(other));
     };
 
     /// returns a new list which is the result of concatenation to range
@@ -523,7 +810,7 @@ public:
         Node* tmp1 = _head;
         Node* tmp2 = list._head;
         for(int i = 0; i < _size; ++i){
-            if(*(tmp1->data) != *(tmp2->data))
+            if(tmp1->data != tmp2->data)
                 return false;
             tmp1 = tmp1->next;
             tmp2 = tmp2->next;
@@ -552,9 +839,19 @@ public:
         using namespace std;
 
         clear();
+        if constexpr(node_traits::propagate_on_container_move_assignment::value)
+            _allocator = std::move(other._allocator);
+        else if(_allocator != other._allocator) {
+            for(auto& element : other)
+                push_back(std::move(element));
+            other.clear();
+            return *this;
+        };
         swap(_size, other._size);
         swap(_head, other._head);
         swap(_tail, other._tail);
+        swap(_finger, other._finger);
+        swap(_finger_index, other._finger_index);
 
         return *this;
     };
@@ -571,47 +868,30 @@ public:
         return *this;
     };
 
-    /*std::string to_string(const int& members_in_line = -1, bool show_indexes = false, bool add_ws = false) const{
-        if(members_in_line == -1)
-            return to_string(_size, show_indexes, add_ws);
-        std::string result = " [ ";
-        if(_size == 0)
-            return result + ']';
-        else {
-            for(int i = 0; i < _size - 1; ++i){
-                std::string tmp;
-                if(show_indexes)
-                    tmp += std::to_string(i) + ':';
-                tmp += std::to_string(get(i)) + ", ";
-                result += tmp;
-                if(members_in_line != 1){
-                    if(i != 0 && i % members_in_line == members_in_line - 1)
-                        result += "\n   ";
-                } else
-                    result += "\n   ";
-            };
-            if(show_indexes)
-                result += std::to_string(_size - 1) + ':';
-            result += std::to_string(back()) + " ]";
+    /// Returns list as text like " [ 0:a, 1:b ]".
+    /// Lines hold members_in_line elements (all in one line if it is <= 0),
+    /// show_indexes prefixes elements with their indexes, add_ws appends a line break
+    std::string to_string(const int& members_in_line = -1, bool show_indexes = false, bool add_ws = false) const{
+        std::string result;
+        {
+            format::Writer out(result);
+            format::write_range(out, begin(), _size, members_in_line, show_indexes);
             if(add_ws)
-                result += '\n';
+                out << '\n';
         };
         return result;
     };
     explicit operator std::string() const{
         return to_string(1, true);
-    };*/
+    };
 
-    /// list supports using output streams with it like std::cout<<
+    /// list supports using output streams with it like std::cout<<.
+    /// Numbers use std::to_chars while out has default formatting, otherwise
+    /// (std::hex, setprecision, setw...) elements are passed to out one by one
     friend std::ostream& operator<<(std::ostream& out, const List& list){
-        out << " [ ";
-        if(list.size() > 0) {
-            auto iter = list.begin();
-            for(int i = 0; i < list.size() - 1; ++i, ++iter)
-                out << *iter << ", ";
-            out << *iter << ' ';
-        };
-        out << "] ";
+        format::Writer writer(out);
+        format::write_range(writer, list.begin(), list.size());
+        writer << ' ';
         return out;
     };
 
@@ -636,6 +916,39 @@ public:
         return in;
     };*/
 
+    /// Writes list in binary format (see _binary.hpp).
+    /// Nodes are copied to a buffer and written in chunks of binary::chunk_bytes
+    void save(std::ostream& out) const{
+        binary::write_header(out, sizeof(T), _size);
+        const int chunk = sizeof(T) < binary::chunk_bytes ? binary::chunk_bytes / int(sizeof(T)) : 1;
+        std::vector<T> buffer(chunk < _size ? chunk : _size);
+
+        const Node* tmp = _head;
+        while(tmp != 0) {
+            int count = 0;
+            for(; count < chunk && tmp != 0; ++count, tmp = tmp->next)
+                buffer[count] = tmp->data;
+            binary::write(out, buffer.data(), count);
+        };
+    };
+    /// Replaces contents with a list written by save().
+    /// Elements are read in chunks and linked in bulk, list is unchanged if reading fails
+    void load(std::istream& in){
+        std::uint64_t count = binary::read_header(in, sizeof(T));
+        if(count > std::uint64_t(std::numeric_limits<int>::max()))
+            throw std::runtime_error("List exception: stored list is too large");
+        const int chunk = sizeof(T) < binary::chunk_bytes ? binary::chunk_bytes / int(sizeof(T)) : 1;
+        std::vector<T> buffer(chunk < int(count) ? chunk : int(count));
+
+        List result(_allocator);
+        for(int left = int(count); left > 0; left -= chunk) {
+            int part = left < chunk ? left : chunk;
+            binary::read(in, buffer.data(), part);
+            result.push_back(buffer.data(), part);
+        };
+        *this = std::move(result);
+    };
+
     /// returns index of data in list or -1 if it is not present
     int find_index(const_reference data){
         auto iter = begin(),
@@ -657,38 +970,138 @@ public:
     };
 
     iterator begin(){
-        return iterator(_head);
+        return iterator(_head, &_tail);
     };
     const_iterator begin() const{
         return cbegin();
     };
     const_iterator cbegin() const{
-        return const_iterator(_head);
+        return const_iterator(_head, &_tail);
     };
 
     iterator at(const int& index){
-        return iterator(_get_node(index));
+        return iterator(_get_node(index), &_tail);
     };
     const_iterator at(const int& index) const{
         return cat(index);
     };
     const_iterator cat(const int& index) const{
-        return const_iterator(_get_node(index));
+        return const_iterator(_get_node(index), &_tail);
+    };
+
+    /// Snapshot of node positions giving O(1) random access, e.g. for std::sort.
+    /// Values are read and written through the nodes, the list itself is not relinked
+    view indexed_view(){
+        return view(_head, _size);
+    };
+    const_view indexed_view() const{
+        return const_view(_head, _size);
     };
 
     iterator end(){
-        return iterator(_tail->next);
+        return iterator(static_cast<Node*>(0), &_tail);
     };
     const_iterator end() const{
         return cend();
     };
     const_iterator cend() const{
-        return const_iterator(_tail->next);
+        return const_iterator(static_cast<const Node*>(0), &_tail);
     };
 
-    /// sort using std::sort
+    /// Stable merge sort relinking nodes in O(n log n) with O(1) extra memory.
+    /// Elements are never copied or moved
+    template<typename Compare>
+    void sort(Compare compare) {
+        if(_size < 2)
+            return;
+        _head = sort_chain(_head, compare);
+        _relink();
+    };
     void sort() {
-        std::sort(begin(), end());
+        sort(std::less<T>());
+    };
+
+    /// Stable merge sort over several threads.
+    /// The chain is cut into one run per thread in a single pass, runs are sorted
+    /// independently by relinking and then merged pairwise in parallel.
+    /// 'threads' <= 0 means all hardware threads, small lists are sorted in place.
+    /// Compare is copied for every thread and must not throw
+    template<typename Compare>
+    void parallel_sort(Compare compare, int threads = 0) {
+        if(threads <= 0)
+            threads = int(std::thread::hardware_concurrency());
+        if(threads > _size / parallel_sort_run)
+            threads = _size / parallel_sort_run;
+        if(threads < 2) {
+            sort(compare);
+            return;
+        };
+
+        std::vector<Node*> runs(threads);
+        Node* tmp = _head;
+        for(int i = 0; i < threads; ++i) {
+            runs[i] = tmp;
+            int length = _size / threads + (i < _size % threads ? 1 : 0);
+            for(int j = 1; j < length; ++j)
+                tmp = tmp->next;
+            Node* next = tmp->next;
+            tmp->next = 0;
+            tmp = next;
+        };
+
+        std::vector<std::thread> workers;
+        for(int i = 1; i < threads; ++i)
+            workers.emplace_back([&runs, i, compare]() mutable {
+                runs[i] = sort_chain(runs[i], compare);
+            });
+        runs[0] = sort_chain(runs[0], compare);
+        for(auto& worker : workers)
+            worker.join();
+
+        // earlier runs go first while merging to keep the sort stable
+        for(int step = 1; step < threads; step *= 2) {
+            workers.clear();
+            for(int i = 0; i + step < threads; i += 2 * step)
+                workers.emplace_back([&runs, i, step, compare]() mutable {
+                    runs[i] = merge_chains(runs[i], runs[i + step], compare);
+                });
+            for(auto& worker : workers)
+                worker.join();
+        };
+
+        _head = runs[0];
+        _relink();
+    };
+    void parallel_sort(int threads = 0) {
+        parallel_sort(std::less<T>(), threads);
+    };
+
+    /// Merges sorted 'other' into this sorted list by relinking nodes, 'other' becomes empty.
+    /// Equal elements of this list go first
+    template<typename Compare>
+    void merge(List&& other, Compare compare) {
+        if(this == &other || other._size == 0)
+            return;
+
+        Node* last = _tail;
+        splice(cend(), std::move(other));
+        if(last == 0)
+            return;
+
+        Node* second = last->next;
+        last->next = 0;
+        _head = merge_chains(_head, second, compare);
+        _relink();
+    };
+    void merge(List&& other) {
+        merge(std::move(other), std::less<T>());
+    };
+    template<typename Compare>
+    void merge(List& other, Compare compare) {
+        merge(std::move(other), compare);
+    };
+    void merge(List& other) {
+        merge(std::move(other), std::less<T>());
     };
 
     ~List(){
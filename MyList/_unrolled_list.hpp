@@ -0,0 +1,387 @@
+#ifndef UNROLLEDLIST_H
+#define UNROLLEDLIST_H
+#include <iostream>
+#include <stdexcept>
+#include "unrolled_list_iterator.hpp"
+#include "node_pool.hpp"
+
+/// default amount of values in one node of UnrolledList, about 256 bytes of payload
+template<typename T>
+constexpr int unrolled_capacity() {
+    return sizeof(T) * 4 < 256 ? int(256 / sizeof(T)) : 4;
+};
+
+/// Unrolled double-linked list.
+/// Every node holds up to Capacity values in a contiguous block, full nodes are split
+/// on insertion and nodes less than half full are merged with their neighbours on removal
+template<typename T, int Capacity = unrolled_capacity<T>(), typename Allocator = NodePool<T> >
+class UnrolledList {
+private:
+    using Node = UnrolledNode<T, Capacity>;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using reference = T&;
+    using const_reference = const T&;
+    using value = T;
+    using node_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+    using node_traits = std::allocator_traits<node_allocator>;
+
+public:
+    using iterator = UnrolledListIterator<T, Node>;
+    using const_iterator = UnrolledListIterator<const T, const Node>;
+
+private:
+    Node* _head = 0;
+    Node* _tail = 0;
+    int _size = 0;
+    node_allocator _allocator;
+
+    Node* _create_node(Node* prev, Node* next) {
+        Node* node = node_traits::allocate(_allocator, 1);
+        node_traits::construct(_allocator, node, prev, next);
+        return node;
+    };
+    void _destroy_node(Node* node) {
+        node_traits::destroy(_allocator, node);
+        node_traits::deallocate(_allocator, node, 1);
+    };
+
+    /// creates an empty node right after 'after' (or at the head if 'after' is null)
+    Node* _link_node_after(Node* after) {
+        Node* next = after != 0 ? after->next : _head;
+        Node* node = _create_node(after, next);
+        if(after != 0)
+            after->next = node;
+        else
+            _head = node;
+        if(next != 0)
+            next->prev = node;
+        else
+            _tail = node;
+        return node;
+    };
+    /// unlinks and destroys a node
+    void _unlink_node(Node* node) {
+        if(node->prev != 0)
+            node->prev->next = node->next;
+        else
+            _head = node->next;
+        if(node->next != 0)
+            node->next->prev = node->prev;
+        else
+            _tail = node->prev;
+        _destroy_node(node);
+    };
+
+    /// Returns the node holding element 'index',
+    /// 'index' is replaced by offset inside of that node
+    Node* _locate(int& index) const {
+        if(index > _size / 2) {
+            Node* tmp = _tail;
+            int first = _size - tmp->count;
+            while(index < first) {
+                tmp = tmp->prev;
+                first -= tmp->count;
+            };
+            index -= first;
+            return tmp;
+        };
+
+        Node* tmp = _head;
+        while(index >= tmp->count) {
+            index -= tmp->count;
+            tmp = tmp->next;
+        };
+        return tmp;
+    };
+
+    /// Merges an underfilled node with the next one or takes some of its values,
+    /// the tail is merged with the previous node the same way
+    void _rebalance(Node* node) {
+        if(node->count == 0) {
+            _unlink_node(node);
+            return;
+        };
+        if(node->count >= Capacity / 2)
+            return;
+
+        if(node->next == 0) {
+            Node* prev = node->prev;
+            if(prev == 0)
+                return;
+            if(prev->count + node->count <= Capacity) {
+                node->move_back_to(prev, 0);
+                _unlink_node(node);
+            } else
+                node->steal_back(prev, (prev->count - node->count) / 2);
+            return;
+        };
+
+        Node* next = node->next;
+        if(node->count + next->count <= Capacity) {
+            next->move_back_to(node, 0);
+            _unlink_node(next);
+        } else
+            node->steal_front(next, (next->count - node->count) / 2);
+    };
+
+    template<typename ...Arguments>
+    void _emplace(const int& index, Arguments&&... args) {
+        _check_except_index_insert(index);
+        if(index == _size) {
+            emplace_back(std::forward<Arguments>(args)...);
+            return;
+        };
+
+        int offset = index;
+        Node* node = _locate(offset);
+        if(node->full()) {
+            // split the node in halves
+            Node* next = _link_node_after(node);
+            node->move_back_to(next, Capacity / 2);
+            if(offset > Capacity / 2) {
+                offset -= Capacity / 2;
+                node = next;
+            };
+        };
+
+        node->emplace(offset, std::forward<Arguments>(args)...);
+        ++_size;
+    };
+
+    /// check index for exception
+    void _check_except_index(const int& index) const {
+        if(index < 0 || index >= _size)
+            throw std::runtime_error("UnrolledList exception: index out of range");
+    };
+    void _check_except_index_insert(const int& index) const {
+        if(index < 0 || index > _size)
+            throw std::runtime_error("UnrolledList exception: index out of range");
+    };
+
+public:
+    UnrolledList() : _head(0), _tail(0), _size(0), _allocator() {};
+    explicit UnrolledList(const Allocator& allocator) : _head(0), _tail(0), _size(0), _allocator(allocator) {};
+    UnrolledList(const UnrolledList& other)
+        : UnrolledList(node_traits::select_on_container_copy_construction(other._allocator)) {
+        for(const auto& element : other)
+            push_back(element);
+    };
+    UnrolledList(UnrolledList&& other) : _allocator(std::move(other._allocator)) {
+        std::swap(_head, other._head);
+        std::swap(_tail, other._tail);
+        std::swap(_size, other._size);
+    };
+    UnrolledList(const std::initializer_list<T>& list) : UnrolledList(list.begin(), list.end()) {};
+    /// Range constructor.
+    /// ForwardIterator must support dereferencing and prefix increment,
+    /// 'to' is not dereferenced!
+    template<typename ForwardIterator>
+    UnrolledList(const ForwardIterator& from, const ForwardIterator& to) : UnrolledList() {
+        for(auto iter = from; iter != to; ++iter)
+            push_back(*iter);
+    };
+
+    /// adds data to the end
+    void push_back(const_reference data){
+        emplace_back(data);
+    };
+    void push_back(value&& data){
+        emplace_back(std::move(data));
+    };
+    template<typename ...Arguments>
+    reference emplace_back(Arguments&&... args){
+        if(_tail == 0 || _tail->full())
+            _link_node_after(_tail);
+        _tail->emplace(_tail->count, std::forward<Arguments>(args)...);
+        ++_size;
+        return _tail->data()[_tail->count - 1];
+    };
+
+    /// adds data to the beginning
+    void push_front(const_reference data){
+        emplace_front(data);
+    };
+    void push_front(value&& data){
+        emplace_front(std::move(data));
+    };
+    template<typename ...Arguments>
+    reference emplace_front(Arguments&&... args){
+        if(_head == 0 || _head->full())
+            _link_node_after(0);
+        _head->emplace(0, std::forward<Arguments>(args)...);
+        ++_size;
+        return _head->data()[0];
+    };
+
+    /// inserts 'data' at 'index'
+    void insert(const_reference data, const int& index){
+        _emplace(index, data);
+    };
+    void insert(value&& data, const int& index){
+        _emplace(index, std::move(data));
+    };
+
+    /// removes data at 'index' returning its copy
+    value remove(const int& index){
+        _check_except_index(index);
+
+        int offset = index;
+        Node* node = _locate(offset);
+        value result = std::move(node->data()[offset]);
+        node->erase(offset);
+        --_size;
+        _rebalance(node);
+
+        return result;
+    };
+    /// removes the last element returning its copy
+    value pop_back(){
+        return remove(_size - 1);
+    };
+    /// removes the first element returning its copy
+    value pop_front(){
+        return remove(0);
+    };
+
+    /// returns reference to the element with the 'index'
+    reference get(const int& index){
+        _check_except_index(index);
+        int offset = index;
+        return _locate(offset)->data()[offset];
+    };
+    const_reference get(const int& index) const{
+        _check_except_index(index);
+        int offset = index;
+        return _locate(offset)->data()[offset];
+    };
+    /// sets the value at 'index' to 'data'
+    void set(const int& index, const_reference data){
+        get(index) = data;
+    };
+
+    reference front(){
+        return get(0);
+    };
+    const_reference front() const{
+        return get(0);
+    };
+    reference back(){
+        return get(_size - 1);
+    };
+    const_reference back() const{
+        return get(_size - 1);
+    };
+
+    reference operator[](const int& index) {
+        return get(index);
+    };
+    const_reference operator[](const int& index) const {
+        return get(index);
+    };
+
+    const int& size() const{
+        return _size;
+    };
+    /// true if the list is empty
+    bool empty() const{
+        return _size == 0;
+    };
+    /// Destroys every element.
+    /// A pooled allocator frees its slabs at once instead of node by node
+    void clear(){
+        if constexpr(has_release<node_allocator>::value)
+            if(_allocator.unique()) {
+                if constexpr(!std::is_trivially_destructible<T>::value)
+                    for(Node* tmp = _head; tmp != 0; tmp = tmp->next)
+                        node_traits::destroy(_allocator, tmp);
+                _allocator.release();
+                _head = _tail = 0;
+                _size = 0;
+                return;
+            };
+
+        while(_head != 0) {
+            Node* tmp = _head;
+            _head = _head->next;
+            _destroy_node(tmp);
+        };
+        _head = _tail = 0;
+        _size = 0;
+    };
+    /// prints the list in []-brackets
+    void print() const {
+        std::cout << *this;
+    };
+
+    bool operator==(const UnrolledList& list) const{
+        if(_size != list._size)
+            return false;
+        auto iter1 = begin(), iter2 = list.begin(), last = end();
+        for(; iter1 != last; ++iter1, ++iter2)
+            if(*iter1 != *iter2)
+                return false;
+        return true;
+    };
+    bool operator!=(const UnrolledList& list) const{
+        return !(*this == list);
+    };
+
+    const UnrolledList& operator=(const UnrolledList& other){
+        if(this != &other){
+            clear();
+            for(const auto& element : other)
+                push_back(element);
+        };
+        return *this;
+    };
+    const UnrolledList& operator=(UnrolledList&& other){
+        if(this != &other){
+            clear();
+            _allocator = std::move(other._allocator);
+            std::swap(_head, other._head);
+            std::swap(_tail, other._tail);
+            std::swap(_size, other._size);
+        };
+        return *this;
+    };
+
+    /// list supports using output streams with it like std::cout<<
+    friend std::ostream& operator<<(std::ostream& out, const UnrolledList& list){
+        out << " [ ";
+        if(list.size() > 0) {
+            auto iter = list.begin();
+            for(int i = 0; i < list.size() - 1; ++i, ++iter)
+                out << *iter << ", ";
+            out << *iter << ' ';
+        };
+        out << "] ";
+        return out;
+    };
+
+    iterator begin(){
+        return iterator(_head, &_tail);
+    };
+    const_iterator begin() const{
+        return cbegin();
+    };
+    const_iterator cbegin() const{
+        return const_iterator(_head, &_tail);
+    };
+
+    iterator end(){
+        return iterator(0, &_tail);
+    };
+    const_iterator end() const{
+        return cend();
+    };
+    const_iterator cend() const{
+        return const_iterator(0, &_tail);
+    };
+
+    ~UnrolledList(){
+        clear();
+    };
+};
+
+#endif // UNROLLEDLIST_H
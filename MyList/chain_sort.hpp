@@ -0,0 +1,54 @@
+#ifndef CHAIN_SORT_HPP
+#define CHAIN_SORT_HPP
+
+/// Merges two sorted null-terminated chains using only 'next' links.
+/// Stable: nodes of 'first' go before equal nodes of 'second'
+template<typename Node, typename Compare>
+Node* merge_chains(Node* first, Node* second, Compare& compare) {
+    Node* result = 0;
+    Node** link = &result;
+    while(first != 0 && second != 0) {
+        if(compare(second->data, first->data)) {
+            *link = second;
+            second = second->next;
+        } else {
+            *link = first;
+            first = first->next;
+        };
+        link = &(*link)->next;
+    };
+    *link = first != 0 ? first : second;
+    return result;
+};
+
+/// Bottom-up merge sort of a null-terminated chain using only 'next' links.
+/// Bin 'i' holds a sorted run of 2^i nodes, so that runs are merged like
+/// a binary counter is incremented. Returns the new first node
+template<typename Node, typename Compare>
+Node* sort_chain(Node* chain, Compare& compare) {
+    Node* bins[64] = {};
+    int top = 0;
+
+    while(chain != 0) {
+        Node* run = chain;
+        chain = chain->next;
+        run->next = 0;
+
+        int i = 0;
+        for(; i < top && bins[i] != 0; ++i) {
+            run = merge_chains(bins[i], run, compare);
+            bins[i] = 0;
+        };
+        if(i == top)
+            ++top;
+        bins[i] = run;
+    };
+
+    Node* result = 0;
+    for(int i = 0; i < top; ++i)
+        if(bins[i] != 0)
+            result = merge_chains(bins[i], result, compare);
+    return result;
+};
+
+#endif // CHAIN_SORT_HPP
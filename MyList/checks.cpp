@@ -0,0 +1,424 @@
+#include "_list.hpp"
+#include "_unrolled_list.hpp"
+#include "_indexed_list.hpp"
+#include <vector>
+#include <string>
+#include <iterator>
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+#include <cstdio>
+#include <deque>
+#include <random>
+#include "../_checks.hpp"
+
+using namespace std;
+using namespace checks;
+
+// a list used as the source of its own insert, concate or splice
+static void check_aliasing() {
+    List<string> list = { "a", "b", "c", "d" };
+    vector<string> expected = { "a", "b", "c", "d" };
+
+    list.insert(list, 2);
+    expected.insert(expected.begin() + 2, { "a", "b", "c", "d" });
+    check(same(list, expected), "insert of the list into itself");
+
+    list.concate(list);
+    vector<string> copy = expected;
+    expected.insert(expected.end(), copy.begin(), copy.end());
+    check(same(list, expected), "concate of the list to itself");
+
+    list.insert(list.begin(), list.end(), 1);
+    copy = expected;
+    expected.insert(expected.begin() + 1, copy.begin(), copy.end());
+    check(same(list, expected), "insert of the list's own range");
+
+    list.push_back(&list[0], 1);
+    expected.push_back(expected[0]);
+    check(same(list, expected), "push_back of the list's own element");
+
+    // moves the first three elements to the end
+    list.splice(list.cend(), list, list.cbegin(), std::next(list.cbegin(), 3));
+    rotate(expected.begin(), expected.begin() + 3, expected.end());
+    check(same(list, expected), "splice of a range inside of the list");
+};
+
+// splicing moves nodes between lists, elements keep their addresses
+static void check_splice() {
+    List<string> first = { "a", "b", "c" }, second = { "x", "y", "z" };
+    const string* moved = &second[1];
+    first.get(2);
+    first.splice(first.cat(1), second);
+    check(same(first, vector<string>{ "a", "x", "y", "z", "b", "c" }) && second.empty(),
+          "splice of a whole list");
+    check(&first[2] == moved, "splice relinks nodes of the other list");
+    check(first[5] == "c" && first[4] == "b", "splice keeps indexed access right");
+
+    List<string> other = { "1", "2", "3", "4", "5" };
+    moved = &other[3];
+    first.splice(first.cend(), other, other.cat(1), other.cat(4));
+    check(same(first, vector<string>{ "a", "x", "y", "z", "b", "c", "2", "3", "4" }) &&
+          same(other, vector<string>{ "1", "5" }), "splice of a range of another list");
+    check(&first[8] == moved, "range splice relinks nodes");
+
+    first.splice(first.cbegin(), other, other.cbegin(), other.cend());
+    first.concate(List<string>{ "q" });
+    first.insert(List<string>{ "m", "n" }, 3);
+    check(same(first, vector<string>{ "1", "5", "a", "m", "n", "x", "y", "z", "b", "c", "2", "3", "4", "q" }) &&
+          other.empty(), "concate and insert of temporary lists");
+};
+
+// indexed access near the last accessed node while elements come and go around it
+static void check_finger() {
+    List<int> list;
+    vector<int> expected;
+    for(int i = 0; i < 1000; ++i) {
+        list.push_back(i);
+        expected.push_back(i);
+    };
+    const List<int>& view = list;
+    mt19937 random(5);
+    int index = 500;
+    for(int i = 0; i < 20000; ++i) {
+        int size = int(expected.size());
+        index = (index + int(random() % 7) - 3 + size) % size;
+        switch(random() % 6) {
+        case 0:
+            list.insert(-i, index);
+            expected.insert(expected.begin() + index, -i);
+            break;
+        case 1:
+            check(list.remove(index) == expected[index], "remove near the finger");
+            expected.erase(expected.begin() + index);
+            break;
+        case 2:
+            list.push_front(i);
+            expected.insert(expected.begin(), i);
+            list.pop_back();
+            expected.pop_back();
+            break;
+        case 3:
+            list.pop_front();
+            expected.erase(expected.begin());
+            list.push_back(i);
+            expected.push_back(i);
+            break;
+        default:
+            check(view[index] == expected[index], "indexed access near the finger");
+            list.set(index, i);
+            expected[index] = i;
+        };
+        check(list.size() == int(expected.size()), "size follows inserts and removes");
+    };
+    check(same(list, expected), "finger keeps indexed access right");
+};
+
+/// compares pairs by their first value only, so the order of equal keys shows stability
+static bool by_key(const pair<int, int>& first, const pair<int, int>& second) {
+    return first.first < second.first;
+};
+
+// sort and merge relink nodes keeping equal elements in their order
+static void check_sort() {
+    List<pair<int, int> > list;
+    vector<pair<int, int> > expected;
+    mt19937 random(7);
+    for(int i = 0; i < 10000; ++i) {
+        list.push_back({ int(random() % 100), i });
+        expected.push_back(list.back());
+    };
+    const pair<int, int>* element = &list[4321];
+    list.sort(by_key);
+    stable_sort(expected.begin(), expected.end(), by_key);
+    check(same(list, expected), "sort is stable");
+    check(&*find(list.begin(), list.end(), *element) == element, "sort relinks nodes");
+    bool backward = true;
+    auto iter = list.end();
+    for(auto expected_iter = expected.rbegin(); expected_iter != expected.rend(); ++expected_iter)
+        backward = backward && *--iter == *expected_iter;
+    check(backward && list.back() == expected.back(), "sort restores backward links");
+
+    List<int> numbers = { 5, 3, 9, 1, 1, 7 };
+    numbers.sort();
+    check(same(numbers, vector<int>{ 1, 1, 3, 5, 7, 9 }), "sort with std::less");
+    numbers.sort(greater<int>());
+    check(same(numbers, vector<int>{ 9, 7, 5, 3, 1, 1 }), "sort with a comparator");
+
+    List<pair<int, int> > first = { { 1, 0 }, { 3, 0 }, { 3, 1 }, { 8, 0 } };
+    List<pair<int, int> > second = { { 0, 2 }, { 3, 2 }, { 9, 2 } };
+    first.merge(second, by_key);
+    check(same(first, vector<pair<int, int> >{ { 0, 2 }, { 1, 0 }, { 3, 0 }, { 3, 1 }, { 3, 2 }, { 8, 0 }, { 9, 2 } }) &&
+          second.empty(), "merge keeps equal elements of the list first");
+    List<int> empty;
+    empty.merge(numbers, greater<int>());
+    check(same(empty, vector<int>{ 9, 7, 5, 3, 1, 1 }) && numbers.empty(), "merge into an empty list");
+};
+
+// parallel_sort of lists long enough for several threads is stable and keeps links right
+static void check_parallel_sort() {
+    mt19937 random(8);
+    for(int threads : { 0, 3, 4 }) {
+        List<pair<int, int> > list;
+        vector<pair<int, int> > expected;
+        for(int i = 0; i < 100003; ++i) {
+            list.push_back({ int(random() % 1000), i });
+            expected.push_back(list.back());
+        };
+        list.parallel_sort(by_key, threads);
+        stable_sort(expected.begin(), expected.end(), by_key);
+        check(same(list, expected), "parallel_sort is stable");
+        check(list.back() == expected.back() && *--list.end() == expected.back() && list[50001] == expected[50001],
+              "parallel_sort restores backward links");
+    };
+
+    List<int> small = { 3, 1, 2 };
+    small.parallel_sort(8);
+    check(same(small, vector<int>{ 1, 2, 3 }), "parallel_sort of a small list");
+};
+
+// copies failing in the middle of building nodes leave nothing behind
+static void check_exception_safety() {
+    vector<Counted> values(20);
+    for(int i = 0; i < 20; ++i)
+        values[i].value = i;
+    const int before = Counted::live;
+
+    Counted::throw_after = 10;
+    check(throws([&]() { List<Counted> list(values.begin(), values.end()); }), "range constructor rethrows");
+    check(Counted::live == before, "range constructor releases built elements");
+
+    Counted::throw_after = 5;
+    check(throws([&]() { List<Counted> list(values.data(), 20); }), "buffer constructor rethrows");
+    check(Counted::live == before, "buffer constructor releases built elements");
+
+    Counted::throw_after = 3;
+    check(throws([&]() { List<Counted> list(10, values[0]); }), "fill constructor rethrows");
+    check(Counted::live == before, "fill constructor releases built elements");
+
+    List<Counted> list(values.begin(), values.begin() + 5);
+    Counted::throw_after = 7;
+    check(throws([&]() { list.insert(values.begin(), values.end(), 2); }), "range insert rethrows");
+    check(same(list, vector<Counted>(values.begin(), values.begin() + 5)), "range insert leaves the list unchanged");
+
+    Counted::throw_after = 2;
+    check(throws([&]() { List<Counted> copy(list); }), "copy constructor rethrows");
+    check(Counted::live == before + 5, "copy constructor releases built elements");
+};
+
+// lists written by save() are read back by load() as they were
+static void check_persistence() {
+    List<long> list;
+    for(long i = 0; i < 100000; ++i)
+        list.push_back(i * i - 7);
+    vector<long> expected(list.begin(), list.end());
+
+    stringstream stream;
+    list.save(stream);
+    List<long> loaded = { 1, 2, 3 };
+    loaded.load(stream);
+    check(same(loaded, expected), "save and load round trip");
+
+    stringstream empty;
+    List<long>().save(empty);
+    loaded.load(empty);
+    check(loaded.size() == 0, "round trip of an empty list");
+
+    // a stream cut in the middle of the elements
+    string bytes = stream.str();
+    stringstream truncated(bytes.substr(0, bytes.size() / 2));
+    List<long> kept = { 4, 5 };
+    check(throws([&]() { kept.load(truncated); }), "load of a truncated stream rethrows");
+    check(same(kept, vector<long>{ 4, 5 }), "failed load leaves the list unchanged");
+
+    stream.clear();
+    stream.seekg(0);
+    List<int> other;
+    check(throws([&]() { other.load(stream); }), "load refuses elements of another size");
+};
+
+// lists made from one NodePool take their nodes from the same pool
+static void check_node_pool() {
+    NodePool<int> pool;
+    List<int> first(pool), second(pool), other;
+    for(int i = 0; i < 100; ++i) {
+        first.push_back(i);
+        second.push_back(-i);
+        other.push_back(i);
+    };
+    NodePool<Node<int> > nodes(pool);
+    check(nodes.live() == 200, "lists made from one pool share it");
+
+    first.splice(first.cend(), second);
+    second.push_back(1);
+    first.clear();
+    check(nodes.live() == 1 && second.size() == 1, "clearing one list keeps nodes of the other");
+    second.clear();
+    check(nodes.live() == 0, "cleared lists give back every node");
+    check(other.size() == 100, "default lists keep pools of their own");
+};
+
+// every way of printing a list gives the text of a default std::ostream
+static void check_formatting() {
+    List<double> list = { 1.0 / 3, 1e20, -0.5, 123456789.0, 2.5e-7, 100 };
+    ostringstream expected;
+    expected << " [ ";
+    for(const auto& element : list)
+        expected << element << (&element == &list.back() ? " " : ", ");
+    expected << ']';
+
+    ostringstream streamed;
+    streamed << list;
+    check(streamed.str() == expected.str() + ' ', "operator<< prints like std::ostream");
+    check(list.to_string() == expected.str(), "to_string prints like std::ostream");
+
+#ifdef FORMAT_FD
+    FILE* file = tmpfile();
+    list.print(fileno(file));
+    rewind(file);
+    char buffer[256] = {};
+    size_t length = fread(buffer, 1, sizeof(buffer) - 1, file);
+    fclose(file);
+    check(string(buffer, length) == expected.str() + '\n', "print(fd) prints like std::ostream");
+#endif
+
+    ostringstream precise, precise_expected;
+    precise << setprecision(3) << list;
+    precise_expected << setprecision(3) << " [ " << list.front() << ", ";
+    check(precise.str().compare(0, precise_expected.str().size(), precise_expected.str()) == 0,
+          "operator<< keeps precision of the stream");
+};
+
+// UnrolledList against std::deque, nodes emptied by removals are merged with neighbours
+static void check_unrolled_list() {
+    NodePool<string> pool;
+    UnrolledList<string, 8> list(pool);
+    NodePool<UnrolledNode<string, 8> > nodes(pool);
+    deque<string> expected;
+    for(int i = 0; i < 64; ++i) {
+        list.push_back(to_string(i));
+        expected.push_back(to_string(i));
+    };
+    check(nodes.live() == 8, "UnrolledList fills its nodes");
+
+    // values are removed from the tail node only, it has no next node to merge with
+    for(int i = 0; i < 7; ++i) {
+        list.remove(list.size() - 2);
+        expected.erase(expected.end() - 2);
+    };
+    check(same(list, vector<string>(expected.begin(), expected.end())), "UnrolledList removes values of the tail");
+    // the tail takes values of the previous node instead of keeping one value
+    bool filled = true;
+    for(int i = list.size() - 4; i < list.size() - 1; ++i)
+        filled = filled && &list.get(i + 1) == &list.get(i) + 1;
+    check(filled, "underfilled tail is refilled from the previous node");
+
+    mt19937 random(7);
+    for(int i = 0; i < 20000; ++i) {
+        int size = int(expected.size());
+        if(size == 0 || random() % 5 < 2) {
+            int index = int(random() % (size + 1));
+            list.insert(to_string(i), index);
+            expected.insert(expected.begin() + index, to_string(i));
+        } else {
+            int index = int(random() % size);
+            check(list.remove(index) == expected[index], "UnrolledList removes the value at index");
+            expected.erase(expected.begin() + index);
+        };
+    };
+    check(same(list, vector<string>(expected.begin(), expected.end())), "UnrolledList matches std::deque");
+    check(int(nodes.live()) <= 2 * list.size() / 8 + 1, "UnrolledList nodes stay at least half full");
+
+    auto iter = list.end();
+    for(auto expected_iter = expected.rbegin(); expected_iter != expected.rend(); ++expected_iter)
+        check(*--iter == *expected_iter, "UnrolledList iterates backwards from end()");
+};
+
+// IndexedList against std::vector, relinking splice, sort and merge keep its levels right
+static void check_indexed_list() {
+    IndexedList<int> list;
+    vector<int> expected;
+    mt19937 random(6);
+    for(int i = 0; i < 20000; ++i) {
+        int size = int(expected.size());
+        int op = int(random() % 5);
+        if(size == 0 || op < 2) {
+            int index = int(random() % (size + 1));
+            list.insert(i, index);
+            expected.insert(expected.begin() + index, i);
+        } else if(op == 2) {
+            int index = int(random() % size);
+            check(list.remove(index) == expected[index], "IndexedList removes the value at index");
+            expected.erase(expected.begin() + index);
+        } else {
+            // indexes near each other are reached from the finger
+            int index = int(random() % size);
+            int step = int(random() % 5) - 2;
+            for(int j = 0; j < 8 && index >= 0 && index < size; ++j, index += step)
+                check(list[index] == expected[index], "IndexedList gets the value at index");
+        };
+    };
+    check(same(list, expected), "IndexedList matches std::vector");
+    check(list.end() - list.begin() == list.size() && *(list.begin() + 777) == expected[777],
+          "IndexedList iterators jump by levels");
+
+    // stable sort of pairs compared by their first value only
+    auto by_key = [](const pair<int, int>& first, const pair<int, int>& second) {
+        return first.first < second.first;
+    };
+    IndexedList<pair<int, int> > pairs;
+    vector<pair<int, int> > sorted;
+    for(int i = 0; i < 5000; ++i) {
+        pairs.push_back({ int(random() % 50), i });
+        sorted.push_back(pairs.back());
+    };
+    const pair<int, int>* element = &pairs[1234];
+    pairs.sort(by_key);
+    stable_sort(sorted.begin(), sorted.end(), by_key);
+    check(same(pairs, sorted), "IndexedList sort is stable");
+    bool relinked = false;
+    for(int i = 0; i < pairs.size(); ++i)
+        relinked = relinked || (&pairs[i] == element && pairs[i].second == 1234);
+    check(relinked, "IndexedList sort relinks nodes");
+
+    IndexedList<int> first = { 1, 3, 5, 7 }, second = { 2, 3, 4, 8, 9 };
+    first.merge(second);
+    check(same(first, vector<int>{ 1, 2, 3, 3, 4, 5, 7, 8, 9 }) && second.empty(), "IndexedList merge");
+
+    IndexedList<int> part = { 10, 11, 12 };
+    first.splice(first.cat(2), part);
+    check(same(first, vector<int>{ 1, 2, 10, 11, 12, 3, 3, 4, 5, 7, 8, 9 }) && part.empty(),
+          "IndexedList splice of a whole list");
+    IndexedList<int> source = { 100, 101, 102, 103 };
+    first.splice(first.cend(), source, source.cat(1), source.cat(3));
+    check(same(first, vector<int>{ 1, 2, 10, 11, 12, 3, 3, 4, 5, 7, 8, 9, 101, 102 }) &&
+          same(source, vector<int>{ 100, 103 }), "IndexedList splice of a range");
+    first.splice(first.cbegin(), first, first.cat(10), first.cend());
+    check(same(first, vector<int>{ 8, 9, 101, 102, 1, 2, 10, 11, 12, 3, 3, 4, 5, 7 }),
+          "IndexedList splice of a range inside of the list");
+    first.insert(42, 5);
+    first.remove(0);
+    check(same(first, vector<int>{ 9, 101, 102, 1, 42, 2, 10, 11, 12, 3, 3, 4, 5, 7 }),
+          "IndexedList levels stay right after splicing");
+
+    // lists of a stateless allocator relink nodes as well
+    IndexedList<string, allocator<string> > strings = { "a", "b" }, more = { "c" };
+    strings.splice(strings.cbegin(), more);
+    check(same(strings, vector<string>{ "c", "a", "b" }) && more.empty(), "IndexedList splice with std::allocator");
+};
+
+int main() {
+    return run([]() {
+        check_aliasing();
+        check_splice();
+        check_finger();
+        check_sort();
+        check_parallel_sort();
+        check_unrolled_list();
+        check_indexed_list();
+        check_exception_safety();
+        check_persistence();
+        check_node_pool();
+        check_formatting();
+    });
+};
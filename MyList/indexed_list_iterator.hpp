@@ -0,0 +1,119 @@
+#ifndef INDEXED_LIST_ITERATOR_HPP
+#define INDEXED_LIST_ITERATOR_HPP
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include "Node.hpp"
+
+/// Random access iterator for IndexedList.
+/// Jumps and distances use skip list levels and take O(log n).
+/// 'value' may be const qualified for read-only iteration
+template<typename container, typename value, typename node>
+class IndexedListIterator {
+public:
+    using value_type = typename std::remove_const<value>::type;
+    using reference = value&;
+    using pointer = value*;
+    using iterator_category = std::random_access_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+
+private:
+    template<typename, typename, typename> friend class IndexedListIterator;
+    friend container;
+
+    const container* _list;
+    node* _node;
+
+public:
+    IndexedListIterator() : _list(0), _node(0) {};
+    IndexedListIterator(const container* list, node* other_node) : _list(list), _node(other_node) {};
+    /// read-only iterator can be made from a mutable one
+    template<typename other_value, typename other_node,
+             typename = typename std::enable_if<std::is_convertible<other_node*, node*>::value>::type>
+    IndexedListIterator(const IndexedListIterator<container, other_value, other_node>& other)
+        : _list(other._list), _node(other._node) {};
+
+    IndexedListIterator& operator++(){
+        if(_node == 0)
+            throw std::runtime_error("\nIndexedList iterator exception: incrementing end iterator");
+        _node = _node->next;
+        return *this;
+    };
+    IndexedListIterator operator++(int){
+        IndexedListIterator copy = *this;
+        ++(*this);
+        return copy;
+    };
+
+    IndexedListIterator& operator--(){
+        _node = _list->_backward(_node, 1);
+        return *this;
+    };
+    IndexedListIterator operator--(int){
+        IndexedListIterator copy = *this;
+        --(*this);
+        return copy;
+    };
+
+    IndexedListIterator& operator+=(const difference_type& distance){
+        if(distance >= 0)
+            _node = _list->_forward(_node, distance);
+        else
+            _node = _list->_backward(_node, -distance);
+        return *this;
+    };
+    IndexedListIterator& operator-=(const difference_type& distance){
+        return *this += -distance;
+    };
+    IndexedListIterator operator+(const difference_type& distance) const{
+        IndexedListIterator result = *this;
+        result += distance;
+        return result;
+    };
+    IndexedListIterator operator-(const difference_type& distance) const{
+        IndexedListIterator result = *this;
+        result -= distance;
+        return result;
+    };
+    friend IndexedListIterator operator+(const difference_type& distance, const IndexedListIterator& iter){
+        return iter + distance;
+    };
+
+    difference_type operator-(const IndexedListIterator& other) const{
+        return difference_type(_list->_index_of(_node)) - _list->_index_of(other._node);
+    };
+
+    reference operator*() const{
+        if(_node == 0)
+            throw std::runtime_error("\nIndexedList iterator exception: dereferencing end iterator");
+        return _node->data;
+    };
+    pointer operator->() const{
+        return &**this;
+    };
+    reference operator[](const difference_type& distance) const{
+        return *(*this + distance);
+    };
+
+    bool operator==(const IndexedListIterator& other) const {
+        return _node == other._node;
+    };
+    bool operator!=(const IndexedListIterator& other) const {
+        return _node != other._node;
+    };
+
+    bool operator<(const IndexedListIterator& other) const {
+        return *this - other < 0;
+    };
+    bool operator>(const IndexedListIterator& other) const {
+        return other < *this;
+    };
+    bool operator<=(const IndexedListIterator& other) const {
+        return !(other < *this);
+    };
+    bool operator>=(const IndexedListIterator& other) const {
+        return !(*this < other);
+    };
+};
+
+#endif // INDEXED_LIST_ITERATOR_HPP
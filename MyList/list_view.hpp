@@ -0,0 +1,144 @@
+#ifndef LIST_VIEW_HPP
+#define LIST_VIEW_HPP
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "Node.hpp"
+
+/// Random access iterator over a ListView.
+/// Walks a contiguous array of node pointers, dereferencing writes through to the nodes
+template<typename value, typename node>
+class ListViewIterator {
+public:
+    using value_type = typename std::remove_const<value>::type;
+    using reference = value&;
+    using pointer = value*;
+    using iterator_category = std::random_access_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+
+private:
+    node* const* _position;
+
+public:
+    ListViewIterator() : _position(0) {};
+    explicit ListViewIterator(node* const* position) : _position(position) {};
+
+    ListViewIterator& operator++(){
+        ++_position;
+        return *this;
+    };
+    ListViewIterator operator++(int){
+        ListViewIterator copy = *this;
+        ++_position;
+        return copy;
+    };
+    ListViewIterator& operator--(){
+        --_position;
+        return *this;
+    };
+    ListViewIterator operator--(int){
+        ListViewIterator copy = *this;
+        --_position;
+        return copy;
+    };
+
+    ListViewIterator& operator+=(const difference_type& distance){
+        _position += distance;
+        return *this;
+    };
+    ListViewIterator& operator-=(const difference_type& distance){
+        _position -= distance;
+        return *this;
+    };
+    ListViewIterator operator+(const difference_type& distance) const{
+        return ListViewIterator(_position + distance);
+    };
+    ListViewIterator operator-(const difference_type& distance) const{
+        return ListViewIterator(_position - distance);
+    };
+    friend ListViewIterator operator+(const difference_type& distance, const ListViewIterator& iter){
+        return iter + distance;
+    };
+    difference_type operator-(const ListViewIterator& other) const{
+        return _position - other._position;
+    };
+
+    reference operator*() const{
+        return (*_position)->data;
+    };
+    pointer operator->() const{
+        return &(*_position)->data;
+    };
+    reference operator[](const difference_type& distance) const{
+        return _position[distance]->data;
+    };
+
+    bool operator==(const ListViewIterator& other) const {
+        return _position == other._position;
+    };
+    bool operator!=(const ListViewIterator& other) const {
+        return _position != other._position;
+    };
+    bool operator<(const ListViewIterator& other) const {
+        return _position < other._position;
+    };
+    bool operator>(const ListViewIterator& other) const {
+        return _position > other._position;
+    };
+    bool operator<=(const ListViewIterator& other) const {
+        return _position <= other._position;
+    };
+    bool operator>=(const ListViewIterator& other) const {
+        return _position >= other._position;
+    };
+};
+
+/// Random access snapshot of a List.
+/// Node pointers are collected once in O(n), after that indexing is O(1) and
+/// algorithms like std::sort or std::nth_element work on the list values in place.
+/// The view is invalidated by any insertion, removal, splice or sort of the list
+template<typename value>
+class ListView {
+private:
+    using node = typename std::conditional<std::is_const<value>::value,
+                                           const Node<typename std::remove_const<value>::type>,
+                                           Node<value> >::type;
+    using reference = value&;
+
+    std::vector<node*> _nodes;
+
+public:
+    using iterator = ListViewIterator<value, node>;
+
+    ListView(node* head, const int& size) {
+        _nodes.reserve(size);
+        for(node* tmp = head; tmp != 0; tmp = tmp->next)
+            _nodes.push_back(tmp);
+    };
+
+    int size() const{
+        return int(_nodes.size());
+    };
+    bool empty() const{
+        return _nodes.empty();
+    };
+
+    reference operator[](const int& index) const{
+        return _nodes[index]->data;
+    };
+    reference get(const int& index) const{
+        if(index < 0 || index >= size())
+            throw std::runtime_error("List view exception: index out of range");
+        return _nodes[index]->data;
+    };
+
+    iterator begin() const{
+        return iterator(_nodes.data());
+    };
+    iterator end() const{
+        return iterator(_nodes.data() + _nodes.size());
+    };
+};
+
+#endif // LIST_VIEW_HPP
@@ -22,7 +22,8 @@ int main() {
     for(auto element : result)
         cout << element << ' ';
 
-    // Iterators provide use with std::sort and others
-    std::sort(result.begin(), result.end());
+    // Indexed view provides use with std::sort and others
+    auto view = result.indexed_view();
+    std::sort(view.begin(), view.end());
     cout << endl << "Sorted list: " << result << endl;
 };
@@ -0,0 +1,353 @@
+#ifndef NODE_POOL_HPP
+#define NODE_POOL_HPP
+#include <new>
+#include <memory>
+#include <cstddef>
+#include <vector>
+#include <utility>
+#include <typeinfo>
+#include <typeindex>
+#include <type_traits>
+
+/// Pools of NodePool allocators rebound from one another, one pool per object type.
+/// Pools are held weakly, a pool lives as long as allocators using it
+struct NodePoolFamily {
+    std::vector<std::pair<std::type_index, std::weak_ptr<void> > > pools;
+
+    /// pool of objects of 'type', null if there is none or it is no longer used
+    template<typename State>
+    std::shared_ptr<State> find(const std::type_index& type) const {
+        for(const auto& entry : pools)
+            if(entry.first == type)
+                return std::static_pointer_cast<State>(entry.second.lock());
+        return 0;
+    };
+    /// registers pool of objects of 'type' replacing one that is no longer used
+    void add(const std::type_index& type, const std::shared_ptr<void>& state) {
+        for(auto& entry : pools)
+            if(entry.first == type) {
+                entry.second = state;
+                return;
+            };
+        pools.emplace_back(type, state);
+    };
+};
+
+/// Slab allocator for list nodes.
+/// Hands out single objects from large contiguous slabs and keeps freed
+/// objects in a free list so they are reused without going back to malloc.
+/// Copies share one pool, pools merged with adopt() also become one pool.
+/// Allocators rebound to other types (as containers do for their nodes) share a family
+/// of pools, so every container made from one NodePool takes its nodes from the same pool.
+/// A pool is not thread-safe
+template<typename T>
+class NodePool {
+public:
+    using value_type = T;
+    using pointer = T*;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
+
+    template<typename U>
+    struct rebind {
+        using other = NodePool<U>;
+    };
+
+    /// amount of objects in the first slab, every next slab doubles up to max_slab
+    static constexpr int first_slab = 16;
+    static constexpr int max_slab = 1 << 16;
+
+private:
+    template<typename> friend class NodePool;
+
+    /// free objects are threaded through their own storage
+    union Slot {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+    /// slab header, slots follow it in the same block
+    struct Slab {
+        Slab* next;
+        int capacity;
+    };
+
+    static constexpr std::size_t _alignment =
+            alignof(Slot) > alignof(Slab) ? alignof(Slot) : alignof(Slab);
+    static constexpr std::size_t _header =
+            (sizeof(Slab) + alignof(Slot) - 1) / alignof(Slot) * alignof(Slot);
+
+    /// Memory of one pool.
+    /// A pool merged into another one forwards to it through 'parent'
+    struct State {
+        std::shared_ptr<State> parent;
+        Slab* slabs = 0;
+        Slot* free = 0;
+        Slot* free_tail = 0;
+        /// not yet used part of the newest slab
+        Slot* cursor = 0;
+        Slot* cursor_end = 0;
+        int next_slab = first_slab;
+        /// objects handed out and not freed yet
+        std::size_t live = 0;
+
+        void release() noexcept {
+            while(slabs != 0) {
+                Slab* next = slabs->next;
+                ::operator delete(slabs, std::align_val_t(_alignment));
+                slabs = next;
+            };
+            free = free_tail = cursor = cursor_end = 0;
+            next_slab = first_slab;
+            live = 0;
+        };
+
+        ~State() {
+            release();
+        };
+    };
+
+    std::shared_ptr<State> _state;
+    /// created once the allocator is rebound, shared by all rebound copies
+    mutable std::shared_ptr<NodePoolFamily> _family;
+
+    static Slot* _slots(Slab* slab) {
+        return reinterpret_cast<Slot*>(reinterpret_cast<unsigned char*>(slab) + _header);
+    };
+
+    /// returns the pool that really owns memory, creating it on first use
+    State& _root() {
+        if(!_state && _family)
+            _state = _family->find<State>(typeid(T));
+        if(!_state) {
+            _state = std::make_shared<State>();
+            if(_family)
+                _family->add(typeid(T), _state);
+        };
+        while(_state->parent)
+            _state = std::shared_ptr<State>(_state->parent);
+        return *_state;
+    };
+    static const State* _find_root(const std::shared_ptr<State>& state) noexcept {
+        const State* tmp = state.get();
+        while(tmp != 0 && tmp->parent)
+            tmp = tmp->parent.get();
+        return tmp;
+    };
+    /// pool used by this allocator, including one created by another member of its family
+    const State* _current_root() const noexcept {
+        if(_state || !_family)
+            return _find_root(_state);
+        // the pool is kept alive by the allocators that created it
+        return _find_root(_family->find<State>(typeid(T)));
+    };
+    /// Family shared with allocators rebound from this one.
+    /// Without memory for it the rebound allocator gets a pool of its own
+    const std::shared_ptr<NodePoolFamily>& _shared_family() const noexcept {
+        if(!_family)
+            try {
+                _family = std::make_shared<NodePoolFamily>();
+                if(_state)
+                    _family->add(typeid(T), _state);
+            } catch(...) {
+                _family.reset();
+            };
+        return _family;
+    };
+
+    /// allocates a slab of 'capacity' slots and links it to the slab list
+    static Slot* _add_slab(State& state, const int& capacity) {
+        void* memory = ::operator new(_header + sizeof(Slot) * capacity, std::align_val_t(_alignment));
+        Slab* slab = static_cast<Slab*>(memory);
+        slab->next = state.slabs;
+        slab->capacity = capacity;
+        state.slabs = slab;
+        return _slots(slab);
+    };
+
+    /// puts an object to the top of the free list
+    static void _push_free(State& state, Slot* slot) noexcept {
+        slot->next = state.free;
+        if(state.free == 0)
+            state.free_tail = slot;
+        state.free = slot;
+    };
+
+public:
+    NodePool() noexcept {};
+    NodePool(const NodePool& other) noexcept : _state(other._state), _family(other._family) {};
+    /// Objects of other types can not share slabs, the pool for T is taken from the family
+    /// of other, so allocators rebound from one NodePool share pools of every type
+    template<typename U>
+    NodePool(const NodePool<U>& other) noexcept : _family(other._shared_family()) {};
+    NodePool(NodePool&& other) noexcept : _state(std::move(other._state)), _family(std::move(other._family)) {};
+
+    NodePool& operator=(const NodePool& other) noexcept {
+        _state = other._state;
+        _family = other._family;
+        return *this;
+    };
+    NodePool& operator=(NodePool&& other) noexcept {
+        _state = std::move(other._state);
+        _family = std::move(other._family);
+        return *this;
+    };
+
+    /// copied containers get a pool of their own
+    NodePool select_on_container_copy_construction() const noexcept {
+        return NodePool();
+    };
+
+    pointer allocate(const size_type& count) {
+        if(count != 1)
+            return static_cast<pointer>(::operator new(sizeof(T) * count, std::align_val_t(alignof(T))));
+
+        State& state = _root();
+        Slot* slot = state.free;
+        if(slot != 0) {
+            state.free = slot->next;
+            if(state.free == 0)
+                state.free_tail = 0;
+        } else {
+            if(state.cursor == state.cursor_end) {
+                state.cursor = _add_slab(state, state.next_slab);
+                state.cursor_end = state.cursor + state.next_slab;
+                if(state.next_slab < max_slab)
+                    state.next_slab *= 2;
+            };
+            slot = state.cursor++;
+        };
+
+        ++state.live;
+        return reinterpret_cast<pointer>(slot);
+    };
+    void deallocate(pointer ptr, const size_type& count) noexcept {
+        if(count != 1) {
+            ::operator delete(ptr, std::align_val_t(alignof(T)));
+            return;
+        };
+
+        State& state = _root();
+        _push_free(state, reinterpret_cast<Slot*>(ptr));
+        --state.live;
+    };
+
+    /// Allocates 'count' adjacent objects at once, each of them is freed with deallocate(ptr, 1).
+    /// If the newest slab has not enough room left its rest goes to the free list
+    pointer allocate_bulk(const size_type& count) {
+        static_assert(sizeof(Slot) == sizeof(T), "NodePool exception: objects smaller than a pointer can not be adjacent");
+        State& state = _root();
+        if(size_type(state.cursor_end - state.cursor) < count) {
+            while(state.cursor != state.cursor_end)
+                _push_free(state, state.cursor++);
+            int capacity = count > size_type(state.next_slab) ? int(count) : state.next_slab;
+            state.cursor = _add_slab(state, capacity);
+            state.cursor_end = state.cursor + capacity;
+            if(state.next_slab < max_slab)
+                state.next_slab *= 2;
+        };
+
+        Slot* first = state.cursor;
+        state.cursor += count;
+        state.live += count;
+        return reinterpret_cast<pointer>(first);
+    };
+
+    /// Merges pool of 'other' into this one.
+    /// Afterwards both allocators compare equal and can free each other's objects.
+    /// The merged pool stays shared, live() tells when one of them holds all its objects
+    void adopt(NodePool& other) {
+        if(!other._state)
+            return;
+        if(!_state) {
+            _state = other._state;
+            return;
+        };
+
+        State& state = _root();
+        State& from = other._root();
+        if(&state == &from)
+            return;
+
+        if(from.slabs != 0) {
+            Slab* last = from.slabs;
+            while(last->next != 0)
+                last = last->next;
+            last->next = state.slabs;
+            state.slabs = from.slabs;
+        };
+        if(from.free != 0) {
+            from.free_tail->next = state.free;
+            if(state.free == 0)
+                state.free_tail = from.free_tail;
+            state.free = from.free;
+        };
+        if(state.cursor == state.cursor_end) {
+            state.cursor = from.cursor;
+            state.cursor_end = from.cursor_end;
+        };
+        if(state.next_slab < from.next_slab)
+            state.next_slab = from.next_slab;
+        state.live += from.live;
+
+        from.slabs = 0;
+        from.free = from.free_tail = from.cursor = from.cursor_end = 0;
+        from.live = 0;
+        other._state->parent = _state;
+        other._state = _state;
+    };
+
+    /// true if no other allocator shares this pool
+    bool unique() const noexcept {
+        return !_state || (!_state->parent && _state.use_count() == 1);
+    };
+    /// amount of single objects handed out and not freed yet by all allocators sharing the pool
+    size_type live() const noexcept {
+        const State* root = _current_root();
+        return root != 0 ? root->live : 0;
+    };
+    /// Frees every slab at once, call it if the pool is not shared or the caller holds all live() objects.
+    /// Objects handed out by the pool must not be used afterwards
+    void release() noexcept {
+        if(_state)
+            _root().release();
+    };
+
+    /// equal allocators share one pool
+    bool operator==(const NodePool& other) const noexcept {
+        return _current_root() == other._current_root();
+    };
+    bool operator!=(const NodePool& other) const noexcept {
+        return !(*this == other);
+    };
+};
+
+/// True if Allocator can free everything it handed out with a single release() call.
+/// unique() tells whether the memory is not shared with other allocators,
+/// live() how many objects are in use by all of them
+template<typename Allocator, typename = void>
+struct has_release : std::false_type {};
+template<typename Allocator>
+struct has_release<Allocator, std::void_t<decltype(std::declval<Allocator&>().release()),
+                                           decltype(std::declval<const Allocator&>().unique()),
+                                           decltype(std::declval<const Allocator&>().live())> >
+        : std::true_type {};
+
+/// true if Allocator can take over memory handed out by another instance with adopt()
+template<typename Allocator, typename = void>
+struct has_adopt : std::false_type {};
+template<typename Allocator>
+struct has_adopt<Allocator, std::void_t<decltype(std::declval<Allocator&>().adopt(std::declval<Allocator&>()))> >
+        : std::true_type {};
+
+/// true if Allocator can hand out several adjacent objects with allocate_bulk()
+template<typename Allocator, typename = void>
+struct has_allocate_bulk : std::false_type {};
+template<typename Allocator>
+struct has_allocate_bulk<Allocator, std::void_t<decltype(std::declval<Allocator&>().allocate_bulk(std::size_t(1)))> >
+        : std::true_type {};
+
+#endif // NODE_POOL_HPP
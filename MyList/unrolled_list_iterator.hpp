@@ -0,0 +1,91 @@
+#ifndef UNROLLED_LIST_ITERATOR_HPP
+#define UNROLLED_LIST_ITERATOR_HPP
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include "Node.hpp"
+
+/// Bidirectional iterator for UnrolledList.
+/// Walks values of one node contiguously before moving to the next node.
+/// Like ListIterator it keeps the list's tail, so end() can be decremented.
+/// 'value' may be const qualified for read-only iteration
+template<typename value, typename node>
+class UnrolledListIterator {
+public:
+    using value_type = typename std::remove_const<value>::type;
+    using reference = value&;
+    using pointer = value*;
+    using iterator_category = std::bidirectional_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+
+private:
+    template<typename, typename> friend class UnrolledListIterator;
+
+    node* _node;
+    int _offset;
+    /// tail of the list, allows decrementing the end iterator
+    node* const* _tail;
+
+public:
+    UnrolledListIterator() = delete;
+    UnrolledListIterator(node* other_node, node* const* tail = 0, const int& offset = 0)
+        : _node(other_node), _offset(offset), _tail(tail) {};
+    /// read-only iterator can be made from a mutable one
+    template<typename other_value, typename other_node,
+             typename = typename std::enable_if<std::is_convertible<other_node*, node*>::value>::type>
+    UnrolledListIterator(const UnrolledListIterator<other_value, other_node>& other)
+        : _node(other._node), _offset(other._offset), _tail(other._tail) {};
+
+    UnrolledListIterator& operator++(){
+        if(_node == 0)
+            throw std::runtime_error("\nUnrolledList iterator exception: incrementing end iterator");
+        if(++_offset == _node->count) {
+            _node = _node->next;
+            _offset = 0;
+        };
+        return *this;
+    };
+    UnrolledListIterator operator++(int){
+        UnrolledListIterator copy = *this;
+        ++(*this);
+        return copy;
+    };
+
+    UnrolledListIterator& operator--(){
+        if(_node == 0) {
+            if(_tail == 0 || *_tail == 0)
+                throw std::runtime_error("\nUnrolledList iterator exception: decrementing end iterator");
+            _node = *_tail;
+            _offset = _node->count - 1;
+        } else if(_offset == 0) {
+            _node = _node->prev;
+            if(_node != 0)
+                _offset = _node->count - 1;
+        } else
+            --_offset;
+        return *this;
+    };
+    UnrolledListIterator operator--(int){
+        UnrolledListIterator copy = *this;
+        --(*this);
+        return copy;
+    };
+
+    reference operator*() const{
+        if(_node == 0)
+            throw std::runtime_error("\nUnrolledList iterator exception: dereferencing end iterator");
+        return _node->data()[_offset];
+    };
+    pointer operator->() const{
+        return &**this;
+    };
+
+    bool operator==(const UnrolledListIterator& other) const {
+        return _node == other._node && _offset == other._offset;
+    };
+    bool operator!=(const UnrolledListIterator& other) const {
+        return !(*this == other);
+    };
+};
+
+#endif // UNROLLED_LIST_ITERATOR_HPP
@@ -0,0 +1,82 @@
+#ifndef BINARY_HPP
+#define BINARY_HPP
+#include <istream>
+#include <ostream>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+/// Binary format shared by the containers.
+/// A file is a header followed by raw bytes of the elements, so only trivially copyable
+/// types are supported and files are read back on machines with the same byte order.
+/// Header fields are fixed width, the header is 24 bytes without padding:
+/// magic "MCB\0", version, element size, byte order mark, element count
+namespace binary {
+
+constexpr std::uint32_t version = 1;
+/// size of buffers used to stream non-contiguous containers
+constexpr int chunk_bytes = 1 << 16;
+
+struct Header {
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t element_size;
+    /// 0x01020304 written in native byte order
+    std::uint32_t byte_order;
+    std::uint64_t count;
+};
+static_assert(sizeof(Header) == 24, "Binary exception: header must have no padding");
+
+constexpr char magic[4] = {'M', 'C', 'B', '\0'};
+constexpr std::uint32_t byte_order = 0x01020304;
+
+/// writes header of count elements of element_size bytes
+inline void write_header(std::ostream& out, const std::size_t& element_size, const std::size_t& count) {
+    Header header;
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = version;
+    header.element_size = std::uint32_t(element_size);
+    header.byte_order = byte_order;
+    header.count = count;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if(!out)
+        throw std::runtime_error("Binary exception: can not write header");
+};
+/// reads and checks header, returns amount of elements that follow it
+inline std::uint64_t read_header(std::istream& in, const std::size_t& element_size) {
+    Header header;
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if(!in)
+        throw std::runtime_error("Binary exception: can not read header");
+    if(std::memcmp(header.magic, magic, sizeof(magic)) != 0)
+        throw std::runtime_error("Binary exception: not a container file");
+    if(header.version != version)
+        throw std::runtime_error("Binary exception: unsupported version");
+    if(header.byte_order != byte_order)
+        throw std::runtime_error("Binary exception: file has other byte order");
+    if(header.element_size != element_size)
+        throw std::runtime_error("Binary exception: element size does not match");
+    return header.count;
+};
+
+/// writes count elements stored contiguously at data
+template<typename T>
+void write(std::ostream& out, const T* data, const std::size_t& count) {
+    static_assert(std::is_trivially_copyable<T>::value, "Binary exception: elements must be trivially copyable");
+    out.write(reinterpret_cast<const char*>(data), std::streamsize(sizeof(T) * count));
+    if(!out)
+        throw std::runtime_error("Binary exception: can not write elements");
+};
+/// reads count elements to contiguous memory at data
+template<typename T>
+void read(std::istream& in, T* data, const std::size_t& count) {
+    static_assert(std::is_trivially_copyable<T>::value, "Binary exception: elements must be trivially copyable");
+    in.read(reinterpret_cast<char*>(data), std::streamsize(sizeof(T) * count));
+    if(!in)
+        throw std::runtime_error("Binary exception: file ends before its elements");
+};
+
+};
+
+#endif // BINARY_HPP
@@ -0,0 +1,96 @@
+#ifndef CHECKS_HPP
+#define CHECKS_HPP
+#include <iostream>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+/// Helpers shared by checks.cpp drivers of the containers.
+/// A failed check throws std::runtime_error naming what went wrong
+namespace checks {
+
+/// stops the checks with 'what' if condition does not hold
+inline void check(const bool& condition, const char* what) {
+    if(!condition)
+        throw std::runtime_error(std::string("Check failed: ") + what);
+};
+
+/// Element counting its live objects, copying throws once throw_after more copies were made
+struct Counted {
+    static inline int live = 0;
+    static inline int throw_after = -1;
+    int value;
+
+    Counted(const int& value = 0) : value(value) {
+        ++live;
+    };
+    Counted(const Counted& other) : value(other.value) {
+        if(throw_after >= 0 && throw_after-- == 0)
+            throw std::runtime_error("Counted exception: copy failed");
+        ++live;
+    };
+    Counted(Counted&& other) noexcept : value(other.value) {
+        ++live;
+    };
+    Counted& operator=(const Counted& other) {
+        if(throw_after >= 0 && throw_after-- == 0)
+            throw std::runtime_error("Counted exception: copy failed");
+        value = other.value;
+        return *this;
+    };
+    Counted& operator=(Counted&& other) noexcept {
+        value = other.value;
+        return *this;
+    };
+    ~Counted() {
+        --live;
+    };
+    bool operator==(const Counted& other) const {
+        return value == other.value;
+    };
+    bool operator<(const Counted& other) const {
+        return value < other.value;
+    };
+};
+
+/// true if calling function throws, copies of Counted stop throwing afterwards
+template<typename Function>
+bool throws(Function function) {
+    bool thrown = false;
+    try {
+        function();
+    } catch(const std::exception&) {
+        thrown = true;
+    };
+    Counted::throw_after = -1;
+    return thrown;
+};
+
+/// true if container holds exactly the values of expected in the same order
+template<typename Container, typename T>
+bool same(const Container& container, const std::vector<T>& expected) {
+    if(container.size() != int(expected.size()))
+        return false;
+    auto iter = expected.begin();
+    for(const auto& element : container)
+        if(!(element == *iter++))
+            return false;
+    return true;
+};
+
+/// runs every check, prints the first failure and returns exit code of the driver
+template<typename Function>
+int run(Function checks) {
+    try {
+        checks();
+    } catch(const std::exception& error) {
+        std::cout << error.what() << std::endl;
+        return 1;
+    };
+    std::cout << "All checks passed" << std::endl;
+    return 0;
+};
+
+};
+
+#endif // CHECKS_HPP
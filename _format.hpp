@@ -0,0 +1,222 @@
+#ifndef FORMAT_HPP
+#define FORMAT_HPP
+#include <charconv>
+#include <algorithm>
+#include <memory>
+#include <ostream>
+#include <locale>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <cerrno>
+#include <stdexcept>
+#include <type_traits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#define FORMAT_FD 1
+#endif
+
+/// Text output shared by the containers.
+/// Numbers are rendered with std::to_chars into a buffer that is handed to
+/// the destination in large blocks, skipping locale-aware iostream formatting
+namespace format {
+
+/// Buffered text writer to an ostream, a file descriptor (POSIX only) or a string.
+/// An ostream with formatting changed from its defaults (std::hex, precision, width,
+/// boolalpha, a non-classic locale...) is written to directly so its settings apply.
+/// Each thread keeps one buffer that is reused by its writers, a writer created
+/// while another one is active (an element printing itself) gets a buffer of its own.
+/// Other element types fall back to their operator<<
+class Writer {
+public:
+    static constexpr int buffer_size = 1 << 16;
+
+private:
+    /// buffer shared by writers of one thread
+    struct Shared {
+        std::unique_ptr<char[]> data;
+        bool busy = false;
+    };
+    static Shared& _shared() {
+        thread_local Shared shared;
+        return shared;
+    };
+
+    /// owned only if the shared buffer is busy
+    std::unique_ptr<char[]> own_;
+    char* buffer_;
+    int used_ = 0;
+    std::ostream* out_ = 0;
+#ifdef FORMAT_FD
+    int fd_ = -1;
+#endif
+    std::string* string_ = 0;
+    /// values are passed to out_ one by one
+    bool direct_ = false;
+
+    /// true if out formats numbers exactly like std::to_chars
+    static bool _default_format(const std::ostream& out) {
+        std::ios_base::fmtflags flags = out.flags() & ~(std::ios_base::skipws | std::ios_base::unitbuf);
+        return flags == std::ios_base::dec && out.precision() == 6 && out.width() == 0 &&
+               out.getloc() == std::locale::classic();
+    };
+
+    char* _acquire() {
+        Shared& shared = _shared();
+        if(shared.busy) {
+            own_.reset(new char[buffer_size]);
+            return own_.get();
+        };
+        if(!shared.data)
+            shared.data.reset(new char[buffer_size]);
+        shared.busy = true;
+        return shared.data.get();
+    };
+
+    /// makes room for at least count chars
+    void _reserve(const int& count) {
+        if(used_ + count > buffer_size)
+            flush();
+    };
+
+public:
+    explicit Writer(std::ostream& out) : buffer_(_acquire()), out_(&out), direct_(!_default_format(out)) {};
+#ifdef FORMAT_FD
+    explicit Writer(const int& fd) : buffer_(_acquire()), fd_(fd) {};
+#endif
+    explicit Writer(std::string& result) : buffer_(_acquire()), string_(&result) {};
+    Writer(const Writer&) = delete;
+    Writer& operator=(const Writer&) = delete;
+
+    ~Writer() {
+        try {
+            flush();
+        } catch(...) {};
+        if(!own_)
+            _shared().busy = false;
+    };
+
+    /// hands buffered text to the destination
+    void flush() {
+        if(used_ == 0)
+            return;
+        int count = used_;
+        used_ = 0;
+
+        if(string_ != 0)
+            string_->append(buffer_, count);
+        else if(out_ != 0)
+            out_->write(buffer_, count);
+#ifdef FORMAT_FD
+        else
+            for(const char* tmp = buffer_; count > 0;) {
+                ssize_t written = ::write(fd_, tmp, count);
+                if(written < 0) {
+                    if(errno == EINTR)
+                        continue;
+                    throw std::runtime_error("Writer exception: can not write to file descriptor");
+                };
+                tmp += written;
+                count -= int(written);
+            };
+#endif
+    };
+
+    Writer& operator<<(const char& symbol) {
+        if(direct_) {
+            *out_ << symbol;
+            return *this;
+        };
+        _reserve(1);
+        buffer_[used_++] = symbol;
+        return *this;
+    };
+    Writer& operator<<(std::string_view text) {
+        if(direct_) {
+            *out_ << text;
+            return *this;
+        };
+        if(int(text.size()) > buffer_size) {
+            // long text is passed through the buffer in whole blocks
+            flush();
+            for(std::size_t i = 0; i < text.size(); i += buffer_size) {
+                std::string_view part = text.substr(i, buffer_size);
+                std::copy(part.begin(), part.end(), buffer_);
+                used_ = int(part.size());
+                flush();
+            };
+            return *this;
+        };
+        _reserve(int(text.size()));
+        std::copy(text.begin(), text.end(), buffer_ + used_);
+        used_ += int(text.size());
+        return *this;
+    };
+    Writer& operator<<(const char* text) {
+        return *this << std::string_view(text);
+    };
+    Writer& operator<<(const std::string& text) {
+        return *this << std::string_view(text);
+    };
+    Writer& operator<<(const bool& value) {
+        if(direct_) {
+            *out_ << value;
+            return *this;
+        };
+        return *this << (value ? '1' : '0');
+    };
+
+    /// Numbers go through std::to_chars, floating point with 6 significant digits like a
+    /// default stream, so every destination gets the same text.
+    /// Other types and single byte characters go through operator<< of std::ostream
+    template<typename T>
+    Writer& operator<<(const T& value) {
+        if(direct_)
+            *out_ << value;
+        else if constexpr(std::is_arithmetic<T>::value && sizeof(T) > 1) {
+            // enough for any integer or floating point with 6 significant digits
+            constexpr int longest = 64;
+            _reserve(longest);
+            std::to_chars_result result;
+            if constexpr(std::is_floating_point<T>::value)
+                result = std::to_chars(buffer_ + used_, buffer_ + used_ + longest, value, std::chars_format::general, 6);
+            else
+                result = std::to_chars(buffer_ + used_, buffer_ + used_ + longest, value);
+            if(result.ec != std::errc())
+                throw std::runtime_error("Writer exception: can not format number");
+            used_ = int(result.ptr - buffer_);
+        } else {
+            std::ostringstream text;
+            text << value;
+            *this << text.str();
+        };
+        return *this;
+    };
+};
+
+/// Writes count elements starting at first like " [ 0:a, 1:b ]".
+/// A line break follows every members_in_line elements (never if it is <= 0),
+/// show_indexes prefixes each element with its index
+template<typename Iterator>
+void write_range(Writer& out, Iterator first, const int& count,
+                 const int& members_in_line = -1, const bool& show_indexes = false) {
+    out << " [ ";
+    for(int i = 0; i < count; ++i, ++first) {
+        if(show_indexes)
+            out << i << ':';
+        out << *first;
+        if(i == count - 1)
+            out << ' ';
+        else {
+            out << ", ";
+            if(members_in_line > 0 && (i + 1) % members_in_line == 0)
+                out << "\n   ";
+        };
+    };
+    out << ']';
+};
+
+};
+
+#endif // FORMAT_HPP